@@ -0,0 +1,53 @@
+/* AttributeBits.cpp
+Copyright (c) 2021 by Michael Zahniser
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "AttributeBits.h"
+
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
+
+using namespace std;
+
+namespace {
+	const size_t WORD_BITS = 64;
+	
+	mutex bitMutex;
+	// The bit that each attribute name has been given.
+	unordered_map<string, size_t> bits;
+}
+
+
+
+AttributeBits::AttributeBits(const set<string> &attributes)
+{
+	lock_guard<mutex> lock(bitMutex);
+	for(const string &attribute : attributes)
+	{
+		size_t bit = bits.emplace(attribute, bits.size()).first->second;
+		if(bit / WORD_BITS >= words.size())
+			words.resize(bit / WORD_BITS + 1);
+		words[bit / WORD_BITS] |= 1ull << (bit % WORD_BITS);
+	}
+}
+
+
+
+// Check if this set has any attribute in common with the given one.
+bool AttributeBits::Intersects(const AttributeBits &other) const
+{
+	size_t size = min(words.size(), other.words.size());
+	for(size_t i = 0; i < size; ++i)
+		if(words[i] & other.words[i])
+			return true;
+	return false;
+}
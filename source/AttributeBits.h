@@ -0,0 +1,45 @@
+/* AttributeBits.h
+Copyright (c) 2021 by Michael Zahniser
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#ifndef ATTRIBUTE_BITS_H_
+#define ATTRIBUTE_BITS_H_
+
+#include <cstdint>
+#include <set>
+#include <string>
+#include <vector>
+
+
+
+// Class representing a set of planet or system attributes as a bitset. Every
+// attribute name that is used anywhere is given its own bit the first time it
+// is seen, so checking whether two sets have any attribute in common compares
+// whole words at once instead of comparing strings. Sets may be created from
+// any thread.
+class AttributeBits {
+public:
+	AttributeBits() = default;
+	explicit AttributeBits(const std::set<std::string> &attributes);
+	
+	// Check if this set has any attribute in common with the given one.
+	bool Intersects(const AttributeBits &other) const;
+	
+	
+private:
+	// Each word holds the bits of 64 attributes. Any words past the end of
+	// this vector are all zeros.
+	std::vector<uint64_t> words;
+};
+
+
+
+#endif
@@ -12,6 +12,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 
 #include "Audio.h"
 
+#include "DirectoryCache.h"
 #include "Files.h"
 #include "Music.h"
 #include "Point.h"
@@ -146,7 +147,7 @@ void Audio::Init(const vector<string> &sources)
 	for(const string &source : sources)
 	{
 		string root = source + "sounds/";
-		vector<string> files = Files::RecursiveList(root);
+		vector<string> files = DirectoryCache::RecursiveList(root);
 		for(const string &path : files)
 		{
 			if(!path.compare(path.length() - 4, 4, ".wav"))
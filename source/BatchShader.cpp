@@ -120,12 +120,16 @@ void BatchShader::Bind()
 
 void BatchShader::Add(const Sprite *sprite, bool isHighDPI, const vector<float> &data)
 {
-	// Do nothing if there are no sprites to draw.
+	// Do nothing if there are no sprites to draw, or if the sprite is still
+	// being loaded.
 	if(data.empty())
 		return;
+	uint32_t texture = sprite->Texture(isHighDPI);
+	if(!texture)
+		return;
 	
 	// First, bind the proper texture.
-	glBindTexture(GL_TEXTURE_2D_ARRAY, sprite->Texture(isHighDPI));
+	glBindTexture(GL_TEXTURE_2D_ARRAY, texture);
 	// The shader also needs to know how many frames the texture has.
 	glUniform1f(frameCountI, sprite->Frames());
 	
@@ -0,0 +1,63 @@
+/* CacheFile.cpp
+Copyright (c) 2021 by Michael Zahniser
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "CacheFile.h"
+
+#include "Files.h"
+
+using namespace std;
+
+
+
+// Strings are stored as their length, followed by their characters.
+void CacheFile::WriteString(string &out, const string &value)
+{
+	WriteInt<uint32_t>(out, value.size());
+	out += value;
+}
+
+
+
+bool CacheFile::ReadString(const char *&it, const char *end, string &value)
+{
+	uint32_t size = 0;
+	if(!ReadInt(it, end, size) || static_cast<size_t>(end - it) < size)
+		return false;
+	value.assign(it, size);
+	it += size;
+	return true;
+}
+
+
+
+// Check that the next string is the given one, without copying it.
+bool CacheFile::MatchString(const char *&it, const char *end, const string &value)
+{
+	uint32_t size = 0;
+	if(!ReadInt(it, end, size) || size != value.size() || static_cast<size_t>(end - it) < size)
+		return false;
+	if(value.compare(0, size, it, size))
+		return false;
+	it += size;
+	return true;
+}
+
+
+
+// Replace the file at the given path with the given data. It is written to
+// a temporary file first, so an interrupted write never leaves a damaged
+// cache behind, and another instance of the game never sees it half written.
+void CacheFile::Replace(const string &path, const string &data)
+{
+	Files::WriteBinary(path + "~", data);
+	Files::Move(path + "~", path);
+}
@@ -0,0 +1,71 @@
+/* CacheFile.h
+Copyright (c) 2021 by Michael Zahniser
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#ifndef CACHE_FILE_H_
+#define CACHE_FILE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+
+
+// Functions for reading and writing the binary files that the game uses to
+// cache data that is slow to load, like parsed data files and decoded images.
+// The values are read from a buffer that the file has been read or mapped
+// into, and each function that reads a value advances the given pointer past
+// it, or returns false if the buffer ends before the value does.
+class CacheFile {
+public:
+	// Integers and floating point values are stored in the native byte order,
+	// because a cache is only ever read on the computer that wrote it.
+	template <class Type>
+	static void WriteInt(std::string &out, Type value);
+	template <class Type>
+	static bool ReadInt(const char *&it, const char *end, Type &value);
+	
+	// Strings are stored as their length, followed by their characters.
+	static void WriteString(std::string &out, const std::string &value);
+	static bool ReadString(const char *&it, const char *end, std::string &value);
+	// Check that the next string is the given one, without copying it.
+	static bool MatchString(const char *&it, const char *end, const std::string &value);
+	
+	// Replace the file at the given path with the given data. It is written to
+	// a temporary file first, so an interrupted write never leaves a damaged
+	// cache behind, and another instance of the game never sees it half written.
+	static void Replace(const std::string &path, const std::string &data);
+};
+
+
+
+template <class Type>
+void CacheFile::WriteInt(std::string &out, Type value)
+{
+	out.append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+
+
+template <class Type>
+bool CacheFile::ReadInt(const char *&it, const char *end, Type &value)
+{
+	if(static_cast<size_t>(end - it) < sizeof(value))
+		return false;
+	std::memcpy(&value, it, sizeof(value));
+	it += sizeof(value);
+	return true;
+}
+
+
+
+#endif
@@ -0,0 +1,272 @@
+/* Compression.cpp
+Copyright (c) 2021 by Michael Zahniser
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "Compression.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+using namespace std;
+
+namespace {
+	// Matches are at least this long, and must begin at least this far from
+	// the end of the data, which must always end in a few literal bytes.
+	const size_t MIN_MATCH = 4;
+	const size_t MATCH_LIMIT = 12;
+	const size_t LAST_LITERALS = 5;
+	// Matches can be at most this far back from the current position.
+	const size_t MAX_OFFSET = 65535;
+	const int HASH_BITS = 16;
+	
+	// Compressed files begin with this header. Like a PNG header, its first
+	// byte cannot begin a plain text file, and its line endings are changed if
+	// the file is ever converted as if it were text.
+	const string FILE_HEADER = "\x89" "ESZ\r\n\x1A\n";
+	// Files are compressed in chunks of at most this many bytes.
+	const size_t CHUNK_SIZE = 1 << 20;
+	
+	uint32_t Read32(const char *data)
+	{
+		uint32_t value;
+		memcpy(&value, data, sizeof(value));
+		return value;
+	}
+	
+	uint32_t Hash(uint32_t value)
+	{
+		return (value * 2654435761u) >> (32 - HASH_BITS);
+	}
+	
+	// Sizes in compressed files are always stored in little-endian byte
+	// order, because the files may be moved from one computer to another.
+	void WriteSize(string &out, size_t pos, uint32_t value)
+	{
+		for(int i = 0; i < 4; ++i)
+			out[pos + i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+	}
+	
+	bool ReadSize(const unsigned char *&it, const unsigned char *end, size_t &value)
+	{
+		if(end - it < 4)
+			return false;
+		value = it[0] | (it[1] << 8) | (it[2] << 16) | (static_cast<uint32_t>(it[3]) << 24);
+		it += 4;
+		return true;
+	}
+	
+	// Lengths that do not fit in the four bits given to them in a sequence's
+	// token are continued in as many bytes as needed.
+	void WriteLength(string &out, size_t length)
+	{
+		for( ; length >= 255; length -= 255)
+			out += static_cast<char>(255);
+		out += static_cast<char>(length);
+	}
+	
+	bool ReadLength(const unsigned char *&it, const unsigned char *end, size_t &length)
+	{
+		unsigned char byte = 255;
+		while(byte == 255)
+		{
+			if(it == end)
+				return false;
+			byte = *it++;
+			length += byte;
+		}
+		return true;
+	}
+	
+	// Write a run of literal bytes, followed by a match if this is not the
+	// last sequence in the data.
+	void WriteSequence(string &out, const char *literals, size_t count, size_t offset = 0, size_t length = 0)
+	{
+		size_t extra = length ? length - MIN_MATCH : 0;
+		out += static_cast<char>((min<size_t>(count, 15) << 4) | min<size_t>(extra, 15));
+		if(count >= 15)
+			WriteLength(out, count - 15);
+		out.append(literals, count);
+		if(!length)
+			return;
+		
+		out += static_cast<char>(offset & 0xFF);
+		out += static_cast<char>(offset >> 8);
+		if(extra >= 15)
+			WriteLength(out, extra - 15);
+	}
+}
+
+
+
+// Compress the given data, appending it to the given string.
+void Compression::Compress(const char *data, size_t size, string &out)
+{
+	size_t anchor = 0;
+	if(size > MATCH_LIMIT)
+	{
+		// The table holds the most recent position where each hashed sequence
+		// of four bytes was seen.
+		vector<uint32_t> table(1 << HASH_BITS, 0);
+		size_t limit = size - MATCH_LIMIT;
+		size_t matchLimit = size - LAST_LITERALS;
+		for(size_t i = 0; i < limit; )
+		{
+			uint32_t sequence = Read32(data + i);
+			uint32_t &entry = table[Hash(sequence)];
+			size_t candidate = entry;
+			entry = i;
+			if(candidate >= i || i - candidate > MAX_OFFSET || Read32(data + candidate) != sequence)
+			{
+				// Skip through data that does not compress more and more quickly.
+				i += 1 + ((i - anchor) >> 6);
+				continue;
+			}
+			
+			size_t length = MIN_MATCH;
+			while(i + length < matchLimit && data[candidate + length] == data[i + length])
+				++length;
+			
+			WriteSequence(out, data + anchor, i - anchor, i - candidate, length);
+			i += length;
+			anchor = i;
+		}
+	}
+	WriteSequence(out, data + anchor, size - anchor);
+}
+
+
+
+// Decompress the given data into a buffer that must be exactly the size of
+// the original data. Returns false if the data is damaged.
+bool Compression::Decompress(const char *data, size_t size, char *out, size_t outSize)
+{
+	const unsigned char *it = reinterpret_cast<const unsigned char *>(data);
+	const unsigned char *end = it + size;
+	char *next = out;
+	char *outEnd = out + outSize;
+	while(it != end)
+	{
+		unsigned char token = *it++;
+		size_t count = token >> 4;
+		if(count == 15 && !ReadLength(it, end, count))
+			return false;
+		if(static_cast<size_t>(end - it) < count || static_cast<size_t>(outEnd - next) < count)
+			return false;
+		memcpy(next, it, count);
+		it += count;
+		next += count;
+		
+		// The last sequence has no match after its literals.
+		if(it == end)
+			break;
+		
+		if(end - it < 2)
+			return false;
+		size_t offset = it[0] | (it[1] << 8);
+		it += 2;
+		size_t length = token & 15;
+		if(length == 15 && !ReadLength(it, end, length))
+			return false;
+		length += MIN_MATCH;
+		if(!offset || offset > static_cast<size_t>(next - out) || static_cast<size_t>(outEnd - next) < length)
+			return false;
+		
+		// A match may overlap the bytes it is producing, repeating them.
+		const char *from = next - offset;
+		if(offset >= length)
+			memcpy(next, from, length);
+		else
+			for(size_t i = 0; i < length; ++i)
+				next[i] = from[i];
+		next += length;
+	}
+	return (next == outEnd);
+}
+
+
+
+// Check whether the given data is a compressed file.
+bool Compression::IsFile(const char *data, size_t size)
+{
+	return (size >= FILE_HEADER.size() && !FILE_HEADER.compare(0, FILE_HEADER.size(), data, FILE_HEADER.size()));
+}
+
+
+
+// Compress the given data as a file, appending it to the given string. The
+// file is split into chunks that are each compressed separately, so that a
+// file can be decompressed without knowing its whole size in advance.
+void Compression::CompressFile(const char *data, size_t size, string &out)
+{
+	out += FILE_HEADER;
+	// Each chunk begins with its original size and its compressed size.
+	for(size_t start = 0; start < size; start += CHUNK_SIZE)
+	{
+		size_t count = min(CHUNK_SIZE, size - start);
+		size_t sizePos = out.size();
+		out.append(8, '\0');
+		Compress(data + start, count, out);
+		WriteSize(out, sizePos, count);
+		WriteSize(out, sizePos + 4, out.size() - sizePos - 8);
+	}
+}
+
+
+
+// Decompress a compressed file, appending it to the given string. Returns
+// false if the file is damaged.
+bool Compression::DecompressFile(const char *data, size_t size, string &out)
+{
+	if(!IsFile(data, size))
+		return false;
+	
+	const unsigned char *it = reinterpret_cast<const unsigned char *>(data) + FILE_HEADER.size();
+	const unsigned char *end = reinterpret_cast<const unsigned char *>(data) + size;
+	while(it != end)
+	{
+		size_t count = 0;
+		size_t compressedSize = 0;
+		if(!ReadSize(it, end, count) || !ReadSize(it, end, compressedSize))
+			return false;
+		if(!count || count > CHUNK_SIZE || compressedSize > static_cast<size_t>(end - it))
+			return false;
+		
+		size_t start = out.size();
+		out.resize(start + count);
+		if(!Decompress(reinterpret_cast<const char *>(it), compressedSize, &out[start], count))
+			return false;
+		it += compressedSize;
+	}
+	return true;
+}
+
+
+
+// Get how many bytes at the start of a compressed file hold its header and
+// its first chunk, which DecompressFile() can decompress on their own, so
+// that the beginning of a file can be read without decompressing all of it.
+// Only the first 16 bytes of the file are needed. Returns 0 if the data is
+// not a compressed file or the file is empty.
+size_t Compression::FirstChunkSize(const char *data, size_t size)
+{
+	if(!IsFile(data, size))
+		return 0;
+	
+	const unsigned char *it = reinterpret_cast<const unsigned char *>(data) + FILE_HEADER.size();
+	const unsigned char *end = reinterpret_cast<const unsigned char *>(data) + size;
+	size_t count = 0;
+	size_t compressedSize = 0;
+	if(!ReadSize(it, end, count) || !ReadSize(it, end, compressedSize))
+		return 0;
+	return FILE_HEADER.size() + 8 + compressedSize;
+}
@@ -0,0 +1,53 @@
+/* Compression.h
+Copyright (c) 2021 by Michael Zahniser
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#ifndef COMPRESSION_H_
+#define COMPRESSION_H_
+
+#include <cstddef>
+#include <string>
+
+
+
+// Fast LZ77 compression, using the same block format as LZ4. This is meant for
+// data that the game writes for itself, like caches, where decompressing it
+// must be much faster than regenerating it, so it trades compression ratio for
+// speed: the decompressor does little more than copy bytes. Data can also be
+// compressed as a file that other computers can read, like a saved game.
+class Compression {
+public:
+	// Compress the given data, appending it to the given string.
+	static void Compress(const char *data, size_t size, std::string &out);
+	// Decompress the given data into a buffer that must be exactly the size of
+	// the original data. Returns false if the data is damaged.
+	static bool Decompress(const char *data, size_t size, char *out, size_t outSize);
+	
+	// Check whether the given data is a compressed file.
+	static bool IsFile(const char *data, size_t size);
+	// Compress the given data as a file, appending it to the given string. The
+	// file is split into chunks that are each compressed separately, so that a
+	// file can be decompressed without knowing its whole size in advance.
+	static void CompressFile(const char *data, size_t size, std::string &out);
+	// Decompress a compressed file, appending it to the given string. Returns
+	// false if the file is damaged.
+	static bool DecompressFile(const char *data, size_t size, std::string &out);
+	// Get how many bytes at the start of a compressed file hold its header and
+	// its first chunk, which DecompressFile() can decompress on their own, so
+	// that the beginning of a file can be read without decompressing all of it.
+	// Only the first 16 bytes of the file are needed. Returns 0 if the data is
+	// not a compressed file or the file is empty.
+	static size_t FirstChunkSize(const char *data, size_t size);
+};
+
+
+
+#endif
@@ -0,0 +1,66 @@
+/* ConditionNames.cpp
+Copyright (c) 2021 by Michael Zahniser
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "ConditionNames.h"
+
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
+using namespace std;
+
+namespace {
+	mutex nameMutex;
+	// A deque never moves its elements when more are added to the end.
+	deque<string> names;
+	unordered_map<string, int> slots;
+}
+
+
+
+// Get the slot of the given condition name, giving it one if necessary.
+int ConditionNames::Intern(const string &name)
+{
+	lock_guard<mutex> lock(nameMutex);
+	auto it = slots.emplace(name, static_cast<int>(names.size()));
+	if(it.second)
+		names.push_back(name);
+	return it.first->second;
+}
+
+
+
+// Get the slot of the given condition name, or -1 if it does not have one.
+int ConditionNames::Find(const string &name)
+{
+	lock_guard<mutex> lock(nameMutex);
+	auto it = slots.find(name);
+	return (it == slots.end() ? -1 : it->second);
+}
+
+
+
+// Get the name stored in the given slot.
+const string &ConditionNames::Name(int slot)
+{
+	lock_guard<mutex> lock(nameMutex);
+	return names[slot];
+}
+
+
+
+// Get how many slots have been given out.
+int ConditionNames::Size()
+{
+	lock_guard<mutex> lock(nameMutex);
+	return names.size();
+}
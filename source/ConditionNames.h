@@ -0,0 +1,39 @@
+/* ConditionNames.h
+Copyright (c) 2021 by Michael Zahniser
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#ifndef CONDITION_NAMES_H_
+#define CONDITION_NAMES_H_
+
+#include <string>
+
+
+
+// Class that gives each distinct condition name a "slot" number, so that a
+// name only needs to be looked up once, when whatever refers to it is loaded.
+// Slots are never reused, and the name stored in a slot never moves in memory,
+// so references to it remain valid for as long as the game runs. This may be
+// used from any thread.
+class ConditionNames {
+public:
+	// Get the slot of the given condition name, giving it one if necessary.
+	static int Intern(const std::string &name);
+	// Get the slot of the given condition name, or -1 if it does not have one.
+	static int Find(const std::string &name);
+	// Get the name stored in the given slot.
+	static const std::string &Name(int slot);
+	// Get how many slots have been given out.
+	static int Size();
+};
+
+
+
+#endif
@@ -14,12 +14,14 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 
 #include "DataNode.h"
 #include "DataWriter.h"
+#include "ConditionNames.h"
 #include "Files.h"
 #include "Random.h"
 
 #include <algorithm>
 #include <cmath>
 #include <limits>
+#include <map>
 #include <set>
 
 using namespace std;
@@ -147,31 +149,18 @@ namespace {
 		return false;
 	}
 	
-	// Converts the given vector of condition tokens (like "reputation: Republic",
-	// "random", or "4") into the integral values they have at runtime.
-	vector<int64_t> SubstituteValues(const vector<string> &side, const map<string, int64_t> &conditions, const map<string, int64_t> &created)
+	// Expressions are short enough that their values almost always fit on a
+	// stack of this size, so it does not need to be allocated.
+	const int STACK_SIZE = 16;
+	
+	// Get the value of the given condition, preferring any temporary value
+	// it has been given over its actual value.
+	int64_t ConditionValue(int slot, const ConditionsStore &conditions, const ConditionsStore &created)
 	{
-		auto result = vector<int64_t>();
-		result.reserve(side.size());
-		for(const string &str : side)
-		{
-			int64_t value = 0;
-			if(str == "random")
-				value = Random::Int(100);
-			else if(DataNode::IsNumber(str))
-				value = static_cast<int64_t>(DataNode::Value(str));
-			else
-			{
-				const auto temp = created.find(str);
-				const auto perm = conditions.find(str);
-				if(temp != created.end())
-					value = temp->second;
-				else if(perm != conditions.end())
-					value = perm->second;
-			}
-			result.emplace_back(value);
-		}
-		return result;
+		const int64_t *value = created.Find(slot);
+		if(!value)
+			value = conditions.Find(slot);
+		return value ? *value : 0;
 	}
 	
 	bool UsedAll(const vector<bool> &status)
@@ -433,6 +422,23 @@ void ConditionSet::Apply(Conditions &conditions) const
 
 
 
+// Add the slots of all the conditions that testing this set reads to the
+// given list. Returns false if the result of the test is random instead.
+bool ConditionSet::ListSlots(vector<int> &slots) const
+{
+	for(const Expression &expression : expressions)
+		if(!expression.ListSlots(slots))
+			return false;
+	
+	for(const ConditionSet &child : children)
+		if(!child.ListSlots(slots))
+			return false;
+	
+	return true;
+}
+
+
+
 // Check if this set is satisfied by either the created, temporary conditions, or the given conditions.
 bool ConditionSet::TestSet(const Conditions &conditions, const Conditions &created) const
 {
@@ -478,6 +484,8 @@ void ConditionSet::TestApply(const Conditions &conditions, Conditions &created)
 ConditionSet::Expression::Expression(const vector<string> &left, const string &op, const vector<string> &right)
 	: op(op), fun(Op(op)), left(left), right(right)
 {
+	if(!IsTestable())
+		slot = ConditionNames::Intern(Name());
 }
 
 
@@ -486,6 +494,8 @@ ConditionSet::Expression::Expression(const vector<string> &left, const string &o
 ConditionSet::Expression::Expression(const string &left, const string &op, const string &right)
 	: op(op), fun(Op(op)), left(left), right(right)
 {
+	if(!IsTestable())
+		slot = ConditionNames::Intern(Name());
 }
 
 
@@ -548,7 +558,7 @@ bool ConditionSet::Expression::Test(const Conditions &conditions, const Conditio
 // Assign the computed value to the desired condition.
 void ConditionSet::Expression::Apply(Conditions &conditions, Conditions &created) const
 {
-	int64_t &c = conditions[Name()];
+	int64_t &c = conditions[slot];
 	int64_t value = right.Evaluate(conditions, created);
 	c = fun(c, value);
 }
@@ -558,13 +568,21 @@ void ConditionSet::Expression::Apply(Conditions &conditions, Conditions &created
 // Assign the computed value to the desired temporary condition.
 void ConditionSet::Expression::TestApply(const Conditions &conditions, Conditions &created) const
 {
-	int64_t &c = created[Name()];
+	int64_t &c = created[slot];
 	int64_t value = right.Evaluate(conditions, created);
 	c = fun(c, value);
 }
 
 
 
+// Add the slots of the conditions that this expression reads.
+bool ConditionSet::Expression::ListSlots(vector<int> &slots) const
+{
+	return left.ListSlots(slots) && right.ListSlots(slots);
+}
+
+
+
 // Constructor for one side of a complex expression (supports multiple simple operators and parentheses).
 ConditionSet::Expression::SubExpression::SubExpression(const vector<string> &side)
 {
@@ -573,6 +591,7 @@ ConditionSet::Expression::SubExpression::SubExpression(const vector<string> &sid
 	
 	ParseSide(side);
 	GenerateSequence();
+	Compile();
 }
 
 
@@ -582,6 +601,7 @@ ConditionSet::Expression::SubExpression::SubExpression(const vector<string> &sid
 ConditionSet::Expression::SubExpression::SubExpression(const string &side)
 {
 	tokens.emplace_back(side.empty() ? "'" : side);
+	Compile();
 }
 
 
@@ -645,22 +665,54 @@ bool ConditionSet::Expression::SubExpression::IsEmpty() const
 int64_t ConditionSet::Expression::SubExpression::Evaluate(const Conditions &conditions, const Conditions &created) const
 {
 	// Sanity check.
-	if(tokens.empty())
+	if(code.empty())
 		return 0;
 	
-	// For SubExpressions with no Operations (i.e. simple conditions), tokens will consist
-	// of only the condition or numeric value to be returned as-is after substitution.
-	auto data = SubstituteValues(tokens, conditions, created);
-	
-	if(!sequence.empty())
+	int64_t buffer[STACK_SIZE];
+	vector<int64_t> large;
+	int64_t *stack = buffer;
+	if(stackSize > STACK_SIZE)
 	{
-		// Each Operation adds to the end of the data vector.
-		data.reserve(operatorCount + data.size());
-		for(const Operation &op : sequence)
-			data.emplace_back(op.fun(data[op.a], data[op.b]));
+		large.resize(stackSize);
+		stack = large.data();
 	}
 	
-	return data.back();
+	int64_t *top = stack;
+	for(const Instruction &instruction : code)
+	{
+		switch(instruction.type)
+		{
+			case Instruction::Type::CONSTANT:
+				*top++ = instruction.value;
+				break;
+			case Instruction::Type::RANDOM:
+				*top++ = Random::Int(100);
+				break;
+			case Instruction::Type::CONDITION:
+				*top++ = ConditionValue(instruction.value, conditions, created);
+				break;
+			case Instruction::Type::OPERATOR:
+				--top;
+				top[-1] = instruction.fun(top[-1], top[0]);
+				break;
+		}
+	}
+	return stack[0];
+}
+
+
+
+// Add the slots of the conditions that this SubExpression reads.
+bool ConditionSet::Expression::SubExpression::ListSlots(vector<int> &slots) const
+{
+	for(const Instruction &instruction : code)
+	{
+		if(instruction.type == Instruction::Type::RANDOM)
+			return false;
+		if(instruction.type == Instruction::Type::CONDITION)
+			slots.push_back(instruction.value);
+	}
+	return true;
 }
 
 
@@ -815,6 +867,62 @@ bool ConditionSet::Expression::SubExpression::AddOperation(vector<int> &data, si
 
 
 
+// Compile the tokens and Operations into code. The value of each Operation is
+// computed by first pushing the values of its two operands onto the stack,
+// which may in turn be the results of other Operations.
+void ConditionSet::Expression::SubExpression::Compile()
+{
+	code.clear();
+	stackSize = 0;
+	if(tokens.empty())
+		return;
+	
+	// The last Operation, or the last token if there are none, is the result.
+	int depth = 0;
+	CompileValue(tokens.size() + sequence.size() - 1, depth);
+	sequence.clear();
+	sequence.shrink_to_fit();
+}
+
+
+
+// Add the code that pushes the token or Operation result with the given index
+// onto the stack, keeping track of how deep the stack gets.
+void ConditionSet::Expression::SubExpression::CompileValue(size_t index, int &depth)
+{
+	Instruction instruction{Instruction::Type::OPERATOR, 0, nullptr};
+	if(index < tokens.size())
+	{
+		// Numbers are parsed and condition names are given a slot just once,
+		// rather than every time this is evaluated.
+		const string &token = tokens[index];
+		if(token == "random")
+			instruction.type = Instruction::Type::RANDOM;
+		else if(DataNode::IsNumber(token))
+		{
+			instruction.type = Instruction::Type::CONSTANT;
+			instruction.value = static_cast<int64_t>(DataNode::Value(token));
+		}
+		else
+		{
+			instruction.type = Instruction::Type::CONDITION;
+			instruction.value = ConditionNames::Intern(token);
+		}
+		stackSize = max(stackSize, ++depth);
+	}
+	else
+	{
+		const Operation &operation = sequence[index - tokens.size()];
+		CompileValue(operation.a, depth);
+		CompileValue(operation.b, depth);
+		instruction.fun = operation.fun;
+		--depth;
+	}
+	code.push_back(instruction);
+}
+
+
+
 // Constructor for an Operation, indicating the binary function and the
 // indices of its operands within the evaluation-time data vector.
 ConditionSet::Expression::SubExpression::Operation::Operation(const string &op, size_t &a, size_t &b)
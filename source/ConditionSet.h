@@ -13,7 +13,8 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #ifndef CONDITION_SET_H_
 #define CONDITION_SET_H_
 
-#include <map>
+#include "ConditionsStore.h"
+
 #include <string>
 #include <vector>
 
@@ -28,7 +29,7 @@ class DataWriter;
 // values.
 class ConditionSet {
 public:
-	using Conditions = std::map<std::string, int64_t>;
+	using Conditions = ConditionsStore;
 	ConditionSet() = default;
 	// Construct and Load() at the same time.
 	ConditionSet(const DataNode &node);
@@ -57,6 +58,9 @@ public:
 	// (Order of operations is like the order of specification: all sibling
 	// expressions are applied, then any and/or nodes are applied.)
 	void Apply(Conditions &conditions) const;
+	// Add the slots of all the conditions that testing this set reads to the
+	// given list. Returns false if the result of the test is random instead.
+	bool ListSlots(std::vector<int> &slots) const;
 	
 	
 private:
@@ -90,13 +94,16 @@ private:
 		bool Test(const Conditions &conditions, const Conditions &created) const;
 		void Apply(Conditions &conditions, Conditions &created) const;
 		void TestApply(const Conditions &conditions, Conditions &created) const;
+		// Add the slots of the conditions that this expression reads.
+		bool ListSlots(std::vector<int> &slots) const;
 		
 		
 	private:
 		// A SubExpression results from applying operator-precedence parsing to one side of
 		// an Expression. The operators and tokens needed to recreate the given side are
 		// stored, and can be interleaved to restore the original string. Based on them, a
-		// sequence of "Operations" is created for runtime evaluation.
+		// sequence of "Operations" is created, which is then compiled into the code that
+		// is run to evaluate the SubExpression.
 		class SubExpression {
 		public:
 			SubExpression(const std::vector<std::string> &side);
@@ -109,14 +116,20 @@ private:
 			
 			bool IsEmpty() const;
 			
-			// Substitute numbers for any string values and then compute the result.
+			// Run this SubExpression's code to compute its value.
 			int64_t Evaluate(const Conditions &conditions, const Conditions &created) const;
+			// Add the slots of the conditions that this SubExpression reads.
+			bool ListSlots(std::vector<int> &slots) const;
 			
 			
 		private:
 			void ParseSide(const std::vector<std::string> &side);
 			void GenerateSequence();
 			bool AddOperation(std::vector<int> &data, size_t &index, const size_t &opIndex);
+			// Convert the tokens and Operations into code, so that evaluating this
+			// SubExpression does not need to parse or allocate anything.
+			void Compile();
+			void CompileValue(size_t index, int &depth);
 			
 			
 		private:
@@ -131,10 +144,29 @@ private:
 				size_t b;
 			};
 			
+			// The code is a sequence of Instructions for a stack machine. Each one
+			// either pushes a value onto the stack, or replaces the top two values
+			// with the result of applying an operator to them.
+			class Instruction {
+			public:
+				enum class Type {CONSTANT, RANDOM, CONDITION, OPERATOR};
+				
+				Type type;
+				// A constant value, or the slot of a condition.
+				int64_t value;
+				// The binary function of an operator.
+				int64_t (*fun)(int64_t, int64_t);
+			};
+			
 			
 		private:
-			// Iteration of the sequence vector yields the result.
+			// The Operations determine the order of the code, and are not needed
+			// once it has been compiled.
 			std::vector<Operation> sequence;
+			// Running the code leaves the result on top of the stack.
+			std::vector<Instruction> code;
+			// The largest number of values that are on the stack at once.
+			int stackSize = 0;
 			// The tokens vector converts into a data vector of numeric values during evaluation.
 			std::vector<std::string> tokens;
 			std::vector<std::string> operators;
@@ -153,6 +185,8 @@ private:
 		// SubExpressions contain one or more tokens and any number of simple operators.
 		SubExpression left;
 		SubExpression right;
+		// The slot of the condition that an assignment modifies.
+		int slot = -1;
 	};
 	
 	
@@ -0,0 +1,343 @@
+/* ConditionsStore.cpp
+Copyright (c) 2021 by Michael Zahniser
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "ConditionsStore.h"
+
+#include "ConditionNames.h"
+
+#include <algorithm>
+
+using namespace std;
+
+namespace {
+	// These are the prefixes of the families of conditions that the game lists
+	// or clears by prefix, so each store keeps track of which of them are set.
+	const string FAMILIES[] = {
+		"salary: ",
+		"tribute: ",
+		"license: ",
+		"ships: ",
+		"flagship system: ",
+		"flagship planet: "
+	};
+	const int FAMILY_COUNT = sizeof(FAMILIES) / sizeof(FAMILIES[0]);
+	
+	// The smallest table that is allocated once anything is stored.
+	const size_t MIN_SIZE = 16;
+	
+	// Slots are handed out in order, so scramble them to spread them evenly
+	// across the table.
+	size_t Hash(int slot, size_t size)
+	{
+		return (static_cast<uint32_t>(slot) * 2654435769u) & (size - 1);
+	}
+	
+	// Find which family the given name belongs to, or -1 if none.
+	int Family(const string &name)
+	{
+		for(int i = 0; i < FAMILY_COUNT; ++i)
+			if(!name.compare(0, FAMILIES[i].length(), FAMILIES[i]))
+				return i;
+		return -1;
+	}
+}
+
+
+
+ConditionsStore::ConditionsStore(initializer_list<pair<string, int64_t>> initial)
+{
+	for(const auto &it : initial)
+		(*this)[it.first] = it.second;
+}
+
+
+
+// Replacing the contents of a store counts as modifying every condition.
+ConditionsStore &ConditionsStore::operator=(const ConditionsStore &other)
+{
+	table = other.table;
+	count = other.count;
+	families = other.families;
+	stamp = max(stamp, other.stamp);
+	Reset();
+	return *this;
+}
+
+
+
+ConditionsStore &ConditionsStore::operator=(ConditionsStore &&other)
+{
+	table = move(other.table);
+	count = other.count;
+	families = move(other.families);
+	stamp = max(stamp, other.stamp);
+	Reset();
+	return *this;
+}
+
+
+
+// Access a condition for modifying it, adding it with a value of 0 if it
+// is not set yet:
+int64_t &ConditionsStore::operator[](const string &name)
+{
+	return (*this)[ConditionNames::Intern(name)];
+}
+
+
+
+int64_t &ConditionsStore::operator[](int slot)
+{
+	Touch(slot);
+	if(table.empty())
+		table.resize(MIN_SIZE, Entry{-1, 0});
+	
+	size_t index = Locate(slot);
+	if(table[index].slot == slot)
+		return table[index].value;
+	
+	// Keep the table at most half full, so that the search for any slot
+	// always ends quickly.
+	if(2 * (count + 1) > table.size())
+	{
+		Grow();
+		index = Locate(slot);
+	}
+	table[index] = Entry{slot, 0};
+	++count;
+	
+	const string &name = ConditionNames::Name(slot);
+	int family = Family(name);
+	if(family >= 0)
+	{
+		if(families.empty())
+			families.resize(FAMILY_COUNT);
+		families[family].emplace(&name, slot);
+	}
+	return table[index].value;
+}
+
+
+
+// Get the value of a condition, or 0 if it is not set:
+int64_t ConditionsStore::Get(const string &name) const
+{
+	const int64_t *value = Find(ConditionNames::Find(name));
+	return value ? *value : 0;
+}
+
+
+
+// Check whether a condition is set, even if its value is 0:
+bool ConditionsStore::Has(const string &name) const
+{
+	return Find(ConditionNames::Find(name));
+}
+
+
+
+// Get the value of a condition, or a null pointer if it is not set:
+const int64_t *ConditionsStore::Find(int slot) const
+{
+	if(slot < 0 || table.empty())
+		return nullptr;
+	
+	const Entry &entry = table[Locate(slot)];
+	return (entry.slot == slot ? &entry.value : nullptr);
+}
+
+
+
+// Remove a condition, or all conditions beginning with the given prefix:
+void ConditionsStore::Erase(const string &name)
+{
+	int slot = ConditionNames::Find(name);
+	if(slot < 0 || table.empty())
+		return;
+	
+	size_t index = Locate(slot);
+	if(table[index].slot == slot)
+	{
+		Touch(slot);
+		EraseAt(index);
+	}
+}
+
+
+
+void ConditionsStore::ErasePrefix(const string &prefix)
+{
+	for(const auto &it : List(prefix))
+		Erase(it.first);
+}
+
+
+
+void ConditionsStore::Clear()
+{
+	table.clear();
+	count = 0;
+	families.clear();
+	Reset();
+}
+
+
+
+bool ConditionsStore::IsEmpty() const
+{
+	return !count;
+}
+
+
+
+size_t ConditionsStore::Size() const
+{
+	return count;
+}
+
+
+
+// Get the names and values of all conditions that begin with the given
+// prefix (or of all conditions, if it is empty), sorted by name.
+vector<pair<string, int64_t>> ConditionsStore::List(const string &prefix) const
+{
+	vector<pair<string, int64_t>> result;
+	if(!count)
+		return result;
+	
+	// If this is one of the families that are kept track of, its conditions
+	// are already known, and already in order.
+	auto it = find(begin(FAMILIES), end(FAMILIES), prefix);
+	if(it != end(FAMILIES))
+	{
+		if(!families.empty())
+			for(const auto &member : families[it - begin(FAMILIES)])
+				result.emplace_back(*member.first, *Find(member.second));
+		return result;
+	}
+	
+	for(const Entry &entry : table)
+		if(entry.slot >= 0)
+		{
+			const string &name = ConditionNames::Name(entry.slot);
+			if(!name.compare(0, prefix.length(), prefix))
+				result.emplace_back(name, entry.value);
+		}
+	sort(result.begin(), result.end());
+	return result;
+}
+
+
+
+// Get a stamp for the current state of this store. Accessing a condition
+// for modifying it afterwards counts as modifying it.
+uint64_t ConditionsStore::Stamp() const
+{
+	isTracked = true;
+	return stamp;
+}
+
+
+
+// Get the slots of the conditions that may have been modified since the
+// given stamp was taken. Returns false if every condition may have been,
+// because the store was cleared or replaced.
+bool ConditionsStore::Changed(uint64_t since, vector<int> &slots) const
+{
+	if(since < resetStamp)
+		return false;
+	
+	for(size_t slot = 0; slot < modified.size(); ++slot)
+		if(modified[slot] > since)
+			slots.push_back(slot);
+	return true;
+}
+
+
+
+// Get the index in the table where the given slot is stored, or would be.
+size_t ConditionsStore::Locate(int slot) const
+{
+	size_t mask = table.size() - 1;
+	size_t index = Hash(slot, table.size());
+	while(table[index].slot >= 0 && table[index].slot != slot)
+		index = (index + 1) & mask;
+	return index;
+}
+
+
+
+// Remove the entry at the given index of the table.
+void ConditionsStore::EraseAt(size_t index)
+{
+	const string &name = ConditionNames::Name(table[index].slot);
+	int family = Family(name);
+	if(family >= 0 && !families.empty())
+		families[family].erase(&name);
+	
+	// Rather than leaving a marker where the entry was, move any entries that
+	// come after it back to fill the gap, if they can be found from there.
+	size_t mask = table.size() - 1;
+	size_t next = index;
+	while(true)
+	{
+		next = (next + 1) & mask;
+		if(table[next].slot < 0)
+			break;
+		
+		// An entry can be moved back if the place it would be stored if there
+		// were no collisions is not between the gap and where it is now.
+		size_t home = Hash(table[next].slot, table.size());
+		bool isBetween = (index <= next) ? (index < home && home <= next) : (index < home || home <= next);
+		if(!isBetween)
+		{
+			table[index] = table[next];
+			index = next;
+		}
+	}
+	table[index].slot = -1;
+	--count;
+}
+
+
+
+// Double the size of the table.
+void ConditionsStore::Grow()
+{
+	vector<Entry> old(table.size() * 2, Entry{-1, 0});
+	old.swap(table);
+	for(const Entry &entry : old)
+		if(entry.slot >= 0)
+			table[Locate(entry.slot)] = entry;
+}
+
+
+
+// Record that the given slot may have been modified.
+void ConditionsStore::Touch(int slot)
+{
+	if(!isTracked)
+		return;
+	
+	if(static_cast<size_t>(slot) >= modified.size())
+		modified.resize(slot + 1);
+	modified[slot] = ++stamp;
+}
+
+
+
+// Record that every condition may have been modified.
+void ConditionsStore::Reset()
+{
+	modified.clear();
+	resetStamp = ++stamp;
+}
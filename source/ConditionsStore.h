@@ -0,0 +1,125 @@
+/* ConditionsStore.h
+Copyright (c) 2021 by Michael Zahniser
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#ifndef CONDITIONS_STORE_H_
+#define CONDITIONS_STORE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+
+// Class for storing the values of a set of named conditions, like the player's
+// conditions. Each name is interned as a slot (see ConditionNames), and values
+// are stored in a hash table keyed by slot, so looking up a condition whose
+// slot is already known does not involve any strings at all. A few families of
+// conditions that the game lists by prefix, like "salary: " and "tribute: ",
+// are also indexed, so that listing them does not require searching through
+// every condition. A store can also report which conditions were modified
+// since a given point, so results that depend on only a few conditions can be
+// kept until one of those conditions changes.
+class ConditionsStore {
+public:
+	ConditionsStore() = default;
+	ConditionsStore(std::initializer_list<std::pair<std::string, int64_t>> initial);
+	ConditionsStore(const ConditionsStore &) = default;
+	ConditionsStore(ConditionsStore &&) = default;
+	// Replacing the contents of a store counts as modifying every condition.
+	ConditionsStore &operator=(const ConditionsStore &other);
+	ConditionsStore &operator=(ConditionsStore &&other);
+	
+	// Access a condition for modifying it, adding it with a value of 0 if it
+	// is not set yet:
+	int64_t &operator[](const std::string &name);
+	int64_t &operator[](int slot);
+	// Get the value of a condition, or 0 if it is not set:
+	int64_t Get(const std::string &name) const;
+	// Check whether a condition is set, even if its value is 0:
+	bool Has(const std::string &name) const;
+	// Get the value of a condition, or a null pointer if it is not set:
+	const int64_t *Find(int slot) const;
+	
+	// Remove a condition, or all conditions beginning with the given prefix:
+	void Erase(const std::string &name);
+	void ErasePrefix(const std::string &prefix);
+	void Clear();
+	
+	bool IsEmpty() const;
+	size_t Size() const;
+	
+	// Get the names and values of all conditions that begin with the given
+	// prefix (or of all conditions, if it is empty), sorted by name.
+	std::vector<std::pair<std::string, int64_t>> List(const std::string &prefix = "") const;
+	
+	// Get a stamp for the current state of this store. Accessing a condition
+	// for modifying it afterwards counts as modifying it.
+	uint64_t Stamp() const;
+	// Get the slots of the conditions that may have been modified since the
+	// given stamp was taken. Returns false if every condition may have been,
+	// because the store was cleared or replaced.
+	bool Changed(uint64_t since, std::vector<int> &slots) const;
+	
+	
+private:
+	// Get the index in the table where the given slot is stored, or would be.
+	size_t Locate(int slot) const;
+	// Remove the entry at the given index of the table.
+	void EraseAt(size_t index);
+	// Double the size of the table.
+	void Grow();
+	// Record that the given slot may have been modified.
+	void Touch(int slot);
+	// Record that every condition may have been modified.
+	void Reset();
+	
+	
+private:
+	class Entry {
+	public:
+		// A slot of -1 means this entry is empty.
+		int slot;
+		int64_t value;
+	};
+	
+	// Order interned names by the strings they point to.
+	class NameOrder {
+	public:
+		bool operator()(const std::string *a, const std::string *b) const { return *a < *b; }
+	};
+	
+	
+private:
+	// An open addressing hash table, which always has a power of two entries
+	// and is never more than half full.
+	std::vector<Entry> table;
+	size_t count = 0;
+	// The names and slots of the conditions in each family that are set.
+	std::vector<std::map<const std::string *, int, NameOrder>> families;
+	
+	// Modifications are only recorded once a stamp has been asked for, so
+	// that temporary stores do not pay for them.
+	mutable bool isTracked = false;
+	uint64_t stamp = 0;
+	// The stamp of the last modification of each slot, indexed by slot.
+	std::vector<uint64_t> modified;
+	// The stamp of the last time every condition was modified at once.
+	uint64_t resetStamp = 0;
+};
+
+
+
+#endif
@@ -0,0 +1,186 @@
+/* DataCache.cpp
+Copyright (c) 2021 by Michael Zahniser
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "DataCache.h"
+
+#include "CacheFile.h"
+#include "DataFile.h"
+#include "DataNode.h"
+#include "Files.h"
+
+using namespace std;
+
+namespace {
+	// The cache begins with this header. Change the version number whenever
+	// the format of the cache or the way that data files are parsed changes,
+	// so that old caches are ignored.
+	const string HEADER = "Endless Sky data cache 1\n";
+}
+
+
+
+// Open the cache at the given path. If it does not exist or was written by
+// a different version of the game, it is treated as being empty.
+DataCache::DataCache(const string &path)
+	: path(path), file(new MappedFile(path)), isDamaged(false)
+{
+	const char *it = file->Data();
+	const char *end = it + file->Size();
+	if(file->Size() < HEADER.size() || HEADER.compare(0, HEADER.size(), it, HEADER.size()))
+		return;
+	it += HEADER.size();
+	
+	// Each file is stored as its path, timestamp, and size, then the number
+	// of bytes in its data, so the data can be skipped until it is needed.
+	while(it != end)
+	{
+		string name;
+		Entry entry;
+		uint64_t bytes = 0;
+		if(!CacheFile::ReadString(it, end, name) || !CacheFile::ReadInt(it, end, entry.timestamp)
+				|| !CacheFile::ReadInt(it, end, entry.size) || !CacheFile::ReadInt(it, end, bytes)
+				|| static_cast<uint64_t>(end - it) < bytes)
+			break;
+		
+		entry.begin = it;
+		entry.end = it + bytes;
+		entries[name] = entry;
+		it = entry.end;
+	}
+}
+
+
+
+// Get the number of data files in the cache.
+size_t DataCache::Count() const
+{
+	return entries.size();
+}
+
+
+
+// Check whether the cache holds the current contents of the given file,
+// or the contents it had when it had the given timestamp and size.
+bool DataCache::IsCurrent(const string &path) const
+{
+	return IsCurrent(path, Files::Timestamp(path), Files::Size(path));
+}
+
+
+
+bool DataCache::IsCurrent(const string &path, int64_t timestamp, uint64_t size) const
+{
+	auto it = entries.find(path);
+	return (it != entries.end() && it->second.timestamp == timestamp && it->second.size == size);
+}
+
+
+
+// Load the given file from the cache. This may be called from any thread.
+// Returns false if the file is not in the cache or its data is damaged.
+bool DataCache::Load(const string &path, DataFile &file) const
+{
+	auto it = entries.find(path);
+	if(it == entries.end())
+		return false;
+	
+	const char *data = it->second.begin;
+	if(Read(data, it->second.end, file.root) && data == it->second.end)
+		return true;
+	
+	// Don't leave a partly loaded file behind.
+	file = DataFile();
+	isDamaged = true;
+	return false;
+}
+
+
+
+// Add a parsed data file to the new version of the cache. The timestamp
+// and size must be those that the file had before it was read, so that
+// if it was changed while it was being read, it will be parsed again.
+void DataCache::Add(const string &path, int64_t timestamp, uint64_t size, const DataFile &file)
+{
+	if(output.empty())
+		output = HEADER;
+	
+	string data;
+	Write(data, file.root);
+	
+	CacheFile::WriteString(output, path);
+	CacheFile::WriteInt<int64_t>(output, timestamp);
+	CacheFile::WriteInt<uint64_t>(output, size);
+	CacheFile::WriteInt<uint64_t>(output, data.size());
+	output += data;
+}
+
+
+
+// Replace the cache file with the new version, if any files were added to it.
+void DataCache::Save()
+{
+	// The old cache must be closed before it can be replaced on Windows.
+	entries.clear();
+	file.reset();
+	
+	if(output.empty())
+	{
+		if(isDamaged)
+			Files::Delete(path);
+		return;
+	}
+	
+	CacheFile::Replace(path, output);
+}
+
+
+
+// Each node is stored as its line number and tokens, followed by its children.
+void DataCache::Write(string &out, const DataNode &node)
+{
+	CacheFile::WriteInt<uint32_t>(out, node.lineNumber);
+	CacheFile::WriteInt<uint32_t>(out, node.tokens.size());
+	for(const string &token : node.tokens)
+		CacheFile::WriteString(out, token);
+	CacheFile::WriteInt<uint32_t>(out, node.children.size());
+	for(const DataNode &child : node.children)
+		Write(out, child);
+}
+
+
+
+bool DataCache::Read(const char *&it, const char *end, DataNode &node)
+{
+	uint32_t lineNumber = 0;
+	uint32_t count = 0;
+	if(!CacheFile::ReadInt(it, end, lineNumber) || !CacheFile::ReadInt(it, end, count))
+		return false;
+	
+	node.lineNumber = lineNumber;
+	node.tokens.resize(count);
+	for(string &token : node.tokens)
+		if(!CacheFile::ReadString(it, end, token))
+			return false;
+	
+	// Every node takes up at least 12 bytes, so a damaged child count can be
+	// caught before trying to allocate space for that many nodes.
+	if(!CacheFile::ReadInt(it, end, count) || static_cast<size_t>(end - it) / 12 < count)
+		return false;
+	node.children.reserve(count);
+	for(uint32_t i = 0; i < count; ++i)
+	{
+		node.children.emplace_back(&node);
+		if(!Read(it, end, node.children.back()))
+			return false;
+	}
+	return true;
+}
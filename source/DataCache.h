@@ -0,0 +1,86 @@
+/* DataCache.h
+Copyright (c) 2021 by Michael Zahniser
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#ifndef DATA_CACHE_H_
+#define DATA_CACHE_H_
+
+#include "MappedFile.h"
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+
+class DataFile;
+class DataNode;
+
+
+
+// A cache of already parsed data files, stored in a compact binary form so
+// that loading them again does not require tokenizing any text. Each file in
+// the cache is stored along with the modification time and size that the data
+// file had when it was parsed, and it is only used if those still match, so
+// any file that has been changed is parsed again. While the cache is being
+// read, a new version of it can be built to replace it.
+class DataCache {
+public:
+	// Open the cache at the given path. If it does not exist or was written by
+	// a different version of the game, it is treated as being empty.
+	explicit DataCache(const std::string &path);
+	
+	// Get the number of data files in the cache.
+	size_t Count() const;
+	// Check whether the cache holds the current contents of the given file,
+	// or the contents it had when it had the given timestamp and size.
+	bool IsCurrent(const std::string &path) const;
+	bool IsCurrent(const std::string &path, int64_t timestamp, uint64_t size) const;
+	// Load the given file from the cache. This may be called from any thread.
+	// Returns false if the file is not in the cache or its data is damaged.
+	// If the cache is damaged and no new version is saved, it is deleted.
+	bool Load(const std::string &path, DataFile &file) const;
+	
+	// Add a parsed data file to the new version of the cache. The timestamp
+	// and size must be those that the file had before it was read, so that
+	// if it was changed while it was being read, it will be parsed again.
+	void Add(const std::string &path, int64_t timestamp, uint64_t size, const DataFile &file);
+	// Replace the cache file with the new version, if any files were added to
+	// it. After this, nothing can be loaded from the old version.
+	void Save();
+	
+	
+private:
+	static void Write(std::string &out, const DataNode &node);
+	static bool Read(const char *&it, const char *end, DataNode &node);
+	
+	
+private:
+	class Entry {
+	public:
+		int64_t timestamp;
+		uint64_t size;
+		const char *begin;
+		const char *end;
+	};
+	
+	std::string path;
+	std::unique_ptr<MappedFile> file;
+	std::map<std::string, Entry> entries;
+	mutable std::atomic<bool> isDamaged;
+	
+	// The new version of the cache.
+	std::string output;
+};
+
+
+
+#endif
@@ -12,8 +12,8 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 
 #include "DataFile.h"
 
-#include "Files.h"
-#include "text/Utf8.h"
+#include "Compression.h"
+#include "MappedFile.h"
 
 using namespace std;
 
@@ -35,22 +35,19 @@ DataFile::DataFile(istream &in)
 
 
 
-// Load from a file path (in UTF-8).
+// Load from a file path (in UTF-8). The file is parsed directly from a memory
+// mapping of it, rather than from a copy.
 void DataFile::Load(const string &path)
 {
-	string data = Files::Read(path);
-	if(data.empty())
+	MappedFile file(path);
+	if(!file.Size())
 		return;
 	
-	// As a sentinel, make sure the file always ends in a newline.
-	if(data.empty() || data.back() != '\n')
-		data.push_back('\n');
-	
 	// Note what file this node is in, so it will show up in error traces.
 	root.tokens.push_back("file");
 	root.tokens.push_back(path);
 	
-	LoadData(data);
+	LoadData(file.Data(), file.Size());
 }
 
 
@@ -68,17 +65,14 @@ void DataFile::Load(istream &in)
 		in.read(&*data.begin() + currentSize, BLOCK);
 		data.resize(currentSize + in.gcount());
 	}
-	// As a sentinel, make sure the file always ends in a newline.
-	if(data.empty() || data.back() != '\n')
-		data.push_back('\n');
 	
-	LoadData(data);
+	LoadData(data.data(), data.size());
 }
 
 
 
 // Get an iterator to the start of the list of nodes in this file.
-list<DataNode>::const_iterator DataFile::begin() const
+vector<DataNode>::const_iterator DataFile::begin() const
 {
 	return root.begin();
 }
@@ -86,16 +80,39 @@ list<DataNode>::const_iterator DataFile::begin() const
 
 
 // Get an iterator to the end of the list of nodes in this file.
-list<DataNode>::const_iterator DataFile::end() const
+vector<DataNode>::const_iterator DataFile::end() const
 {
 	return root.end();
 }
 
 
 
-// Parse the given text.
-void DataFile::LoadData(const string &data)
+// Parse the given text. Every character that has a meaning in the file format
+// is a single byte, and no byte of a multi-byte UTF-8 character can be mistaken
+// for one, so the text can be scanned one byte at a time.
+void DataFile::LoadData(const char *data, size_t size)
 {
+	// Saved games may be compressed, in which case they must be decompressed
+	// before they can be parsed.
+	string text;
+	if(Compression::IsFile(data, size))
+	{
+		if(!Compression::DecompressFile(data, size, text))
+		{
+			root.PrintTrace("Error: unable to decompress file:");
+			return;
+		}
+		data = text.data();
+		size = text.size();
+	}
+	
+	// Get the next character. If the text does not end in a newline, act as if
+	// it does, so the last line is always terminated.
+	auto next = [data, size](size_t &pos) -> char32_t
+	{
+		return (pos < size) ? static_cast<unsigned char>(data[pos++]) : (++pos, '\n');
+	};
+	
 	// Keep track of the current stack of indentation levels and the most recent
 	// node at each level - that is, the node that will be the "parent" of any
 	// new node added at the next deeper indentation level.
@@ -105,12 +122,11 @@ void DataFile::LoadData(const string &data)
 	bool warned = false;
 	size_t lineNumber = 0;
 	
-	size_t end = data.length();
-	for(size_t pos = 0; pos < end; )
+	for(size_t pos = 0; pos < size; )
 	{
 		++lineNumber;
 		size_t tokenPos = pos;
-		char32_t c = Utf8::DecodeCodePoint(data, pos);
+		char32_t c = next(pos);
 		
 		// Find the first non-white character in this line.
 		bool isSpaces = false;
@@ -136,13 +152,13 @@ void DataFile::LoadData(const string &data)
 			
 			++white;
 			tokenPos = pos;
-			c = Utf8::DecodeCodePoint(data, pos);
+			c = next(pos);
 		}
 		
 		// If the line is a comment, skip to the end of the line.
 		if(c == '#')
 			while(c != '\n')
-				c = Utf8::DecodeCodePoint(data, pos);
+				c = next(pos);
 		// Skip empty lines (including comment lines).
 		if(c == '\n')
 			continue;
@@ -156,7 +172,7 @@ void DataFile::LoadData(const string &data)
 		}
 		
 		// Add this node as a child of the proper node.
-		list<DataNode> &children = stack.back()->children;
+		vector<DataNode> &children = stack.back()->children;
 		children.emplace_back(stack.back());
 		DataNode &node = children.back();
 		node.lineNumber = lineNumber;
@@ -175,7 +191,7 @@ void DataFile::LoadData(const string &data)
 			if(isQuoted)
 			{
 				tokenPos = pos;
-				c = Utf8::DecodeCodePoint(data, pos);
+				c = next(pos);
 			}
 			
 			size_t endPos = tokenPos;
@@ -184,16 +200,10 @@ void DataFile::LoadData(const string &data)
 			while(c != '\n' && (isQuoted ? (c != endQuote) : (c > ' ')))
 			{
 				endPos = pos;
-				c = Utf8::DecodeCodePoint(data, pos);
+				c = next(pos);
 			}
 			
-			// It ought to be legal to construct a string from an empty iterator
-			// range, but it appears that some libraries do not handle that case
-			// correctly. So:
-			if(tokenPos == endPos)
-				node.tokens.emplace_back();
-			else
-				node.tokens.emplace_back(data, tokenPos, endPos - tokenPos);
+			node.tokens.emplace_back(data + tokenPos, endPos - tokenPos);
 			// This is not a fatal error, but it may indicate a format mistake:
 			if(isQuoted && c == '\n')
 				node.PrintTrace("Closing quotation mark is missing:");
@@ -205,12 +215,12 @@ void DataFile::LoadData(const string &data)
 				if(isQuoted)
 				{
 					tokenPos = pos;
-					c = Utf8::DecodeCodePoint(data, pos);
+					c = next(pos);
 				}
 				while(c != '\n' && c <= ' ' && c != '#')
 				{
 					tokenPos = pos;
-					c = Utf8::DecodeCodePoint(data, pos);
+					c = next(pos);
 				}
 				
 				// If a comment is encountered outside of a token, skip the rest
@@ -218,7 +228,7 @@ void DataFile::LoadData(const string &data)
 				if(c == '#')
 				{
 					while(c != '\n')
-						c = Utf8::DecodeCodePoint(data, pos);
+						c = next(pos);
 				}
 			}
 		}
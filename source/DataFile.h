@@ -15,9 +15,10 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 
 #include "DataNode.h"
 
+#include <cstddef>
 #include <istream>
-#include <list>
 #include <string>
+#include <vector>
 
 
 
@@ -38,17 +39,20 @@ public:
 	void Load(std::istream &in);
 	
 	// Functions for iterating through all DataNodes in this file.
-	std::list<DataNode>::const_iterator begin() const;
-	std::list<DataNode>::const_iterator end() const;
+	std::vector<DataNode>::const_iterator begin() const;
+	std::vector<DataNode>::const_iterator end() const;
 	
 	
 private:
-	void LoadData(const std::string &data);
+	void LoadData(const char *data, size_t size);
 	
 	
 private:
 	// This is the container for all DataNodes in this file.
 	DataNode root;
+	
+	// Allow DataCache to store and restore the nodes of a file.
+	friend class DataCache;
 };
 
 
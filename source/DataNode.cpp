@@ -43,6 +43,17 @@ DataNode::DataNode(const DataNode &other)
 
 
 
+// Move constructor. The children's own children do not move, so only the
+// direct children need their parent pointers updated.
+DataNode::DataNode(DataNode &&other) noexcept
+	: children(move(other.children)), tokens(move(other.tokens)),
+	parent(other.parent), lineNumber(other.lineNumber)
+{
+	ReparentChildren();
+}
+
+
+
 // Assignment operator.
 DataNode &DataNode::operator=(const DataNode &other)
 {
@@ -54,6 +65,19 @@ DataNode &DataNode::operator=(const DataNode &other)
 
 
 
+// Move assignment operator.
+DataNode &DataNode::operator=(DataNode &&other) noexcept
+{
+	children = move(other.children);
+	tokens = move(other.tokens);
+	parent = other.parent;
+	lineNumber = other.lineNumber;
+	ReparentChildren();
+	return *this;
+}
+
+
+
 // Get the number of tokens in this line of the data file.
 int DataNode::Size() const
 {
@@ -207,7 +231,7 @@ bool DataNode::HasChildren() const
 
 
 // Iterator to the beginning of the list of children.
-list<DataNode>::const_iterator DataNode::begin() const
+vector<DataNode>::const_iterator DataNode::begin() const
 {
 	return children.begin();
 }
@@ -215,60 +239,81 @@ list<DataNode>::const_iterator DataNode::begin() const
 
 
 // Iterator to the end of the list of children.
-list<DataNode>::const_iterator DataNode::end() const
+vector<DataNode>::const_iterator DataNode::end() const
 {
 	return children.end();
 }
 
 
 
-// Print a message followed by a "trace" of this node and its parents.
+// Print a message followed by a "trace" of this node and its parents. The
+// whole trace is logged at once, so traces printed by different threads
+// cannot be interleaved.
 int DataNode::PrintTrace(const string &message) const
 {
-	if(!message.empty())
+	// Put an empty line in the log between each error message.
+	string trace = message.empty() ? "" : '\n' + message;
+	int indent = Trace(trace);
+	if(!trace.empty())
+		Files::LogError(trace);
+	
+	return indent;
+}
+
+
+
+// Adjust the parent pointers when a copy is made of a DataNode.
+void DataNode::Reparent()
+{
+	for(DataNode &child : children)
 	{
-		// Put an empty line in the log between each error message.
-		Files::LogError("");
-		Files::LogError(message);
+		child.parent = this;
+		child.Reparent();
 	}
-	
-	// Recursively print all the parents of this node, so that the user can
+}
+
+
+
+// Adjust the parent pointers of only the direct children, after a move.
+void DataNode::ReparentChildren()
+{
+	for(DataNode &child : children)
+		child.parent = this;
+}
+
+
+
+// Append a line for this node and each of its parents to the given trace,
+// and return the indentation level of this node.
+int DataNode::Trace(string &trace) const
+{
+	// Recursively add all the parents of this node, so that the user can
 	// trace it back to the right point in the file.
-	size_t indent = 0;
+	int indent = 0;
 	if(parent)
-		indent = parent->PrintTrace() + 2;
+		indent = parent->Trace(trace) + 2;
 	if(tokens.empty())
 		return indent;
 	
 	// Convert this node back to tokenized text, with quotes used as necessary.
-	string line = !parent ? "" : "L" + to_string(lineNumber) + ": ";
-	line.append(string(indent, ' '));
+	if(!trace.empty())
+		trace += '\n';
+	if(parent)
+		trace += "L" + to_string(lineNumber) + ": ";
+	trace.append(indent, ' ');
 	for(const string &token : tokens)
 	{
 		if(&token != &tokens.front())
-			line += ' ';
+			trace += ' ';
 		bool hasSpace = any_of(token.begin(), token.end(), [](char c) { return isspace(c); });
 		bool hasQuote = any_of(token.begin(), token.end(), [](char c) { return (c == '"'); });
 		if(hasSpace)
-			line += hasQuote ? '`' : '"';
-		line += token;
+			trace += hasQuote ? '`' : '"';
+		trace += token;
 		if(hasSpace)
-			line += hasQuote ? '`' : '"';
+			trace += hasQuote ? '`' : '"';
 	}
-	Files::LogError(line);
 	
 	// Tell the caller what indentation level we're at now.
 	return indent;
 }
-
-
-
-// Adjust the parent pointers when a copy is made of a DataNode.
-void DataNode::Reparent()
-{
-	for(DataNode &child : children)
-	{
-		child.parent = this;
-		child.Reparent();
-	}
-}
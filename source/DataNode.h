@@ -13,7 +13,6 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #ifndef DATA_NODE_H_
 #define DATA_NODE_H_
 
-#include <list>
 #include <string>
 #include <vector>
 
@@ -32,8 +31,12 @@ public:
 	explicit DataNode(const DataNode *parent = nullptr);
 	// Copy constructor.
 	DataNode(const DataNode &other);
+	// Moving a node keeps its parent and line number, so that a DataFile can
+	// store each node's children contiguously as it loads them.
+	DataNode(DataNode &&other) noexcept;
 	
 	DataNode &operator=(const DataNode &other);
+	DataNode &operator=(DataNode &&other) noexcept;
 	
 	// Get the number of tokens in this node.
 	int Size() const;
@@ -54,8 +57,8 @@ public:
 	// Check if this node has any children. If so, the iterator functions below
 	// can be used to access them.
 	bool HasChildren() const;
-	std::list<DataNode>::const_iterator begin() const;
-	std::list<DataNode>::const_iterator end() const;
+	std::vector<DataNode>::const_iterator begin() const;
+	std::vector<DataNode>::const_iterator end() const;
 	
 	// Print a message followed by a "trace" of this node and its parents.
 	int PrintTrace(const std::string &message = "") const;
@@ -64,11 +67,15 @@ public:
 private:
 	// Adjust the parent pointers when a copy is made of a DataNode.
 	void Reparent();
+	// Adjust the parent pointers of only the direct children, after a move.
+	void ReparentChildren();
+	// Append this node and its parents to the trace, one line per node.
+	int Trace(std::string &trace) const;
 	
 	
 private:
 	// These are "child" nodes found on subsequent lines with deeper indentation.
-	std::list<DataNode> children;
+	std::vector<DataNode> children;
 	// These are the tokens found in this particular line of the data file.
 	std::vector<std::string> tokens;
 	// The parent pointer is used only for printing stack traces.
@@ -76,7 +83,8 @@ private:
 	// The line number in the given file that produced this node.
 	size_t lineNumber = 0;
 	
-	// Allow DataFile to modify the internal structure of DataNodes.
+	// Allow DataFile and DataCache to modify the internal structure of DataNodes.
+	friend class DataCache;
 	friend class DataFile;
 };
 
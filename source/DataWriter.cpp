@@ -15,8 +15,28 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "DataNode.h"
 #include "Files.h"
 
+#include <cmath>
+#include <cstdio>
+
 using namespace std;
 
+namespace {
+	// When writing to a file, the data is written whenever at least this many
+	// bytes of it have been generated.
+	const size_t BUFFER_SIZE = 1 << 16;
+	
+	// Write the digits of the given number, ending just before the given
+	// position in a buffer, and return where they begin.
+	char *FormatDigits(uint64_t value, char *end)
+	{
+		do {
+			*--end = '0' + value % 10;
+			value /= 10;
+		} while(value);
+		return end;
+	}
+}
+
 
 
 // This string constant is just used for remembering what string needs to be
@@ -29,16 +49,21 @@ const string DataWriter::space = " ";
 DataWriter::DataWriter(const string &path)
 	: path(path), before(&indent)
 {
-	out.precision(8);
+	if(!path.empty())
+		file = File(path + "~", true);
 }
 
 
 
-// Destructor, which saves the file all in one block.
+// Destructor, which finishes writing the file and then moves it into place.
 DataWriter::~DataWriter()
 {
-	if(!path.empty())
-		Files::Write(path, out.str());
+	if(!file)
+		return;
+	
+	Flush(true);
+	file = File();
+	Files::Move(path + "~", path);
 }
 
 
@@ -68,8 +93,9 @@ void DataWriter::Write(const DataNode &node)
 // Begin a new line of the file.
 void DataWriter::Write()
 {
-	out << '\n';
+	out += '\n';
 	before = &indent;
+	Flush();
 }
 
 
@@ -93,7 +119,11 @@ void DataWriter::EndChild()
 // Write a comment line, at the current indentation level.
 void DataWriter::WriteComment(const string &str)
 {
-	out << indent << "# " << str << '\n';
+	out += indent;
+	out += "# ";
+	out += str;
+	out += '\n';
+	Flush();
 }
 
 
@@ -111,13 +141,13 @@ void DataWriter::WriteToken(const char *a)
 	}
 	
 	// Write the token, enclosed in quotes if necessary.
-	out << *before;
+	out += *before;
 	if(hasQuote)
-		out << '`' << a << '`';
+		(out += '`').append(a) += '`';
 	else if(hasSpace || a[0] == '\0')
-		out << '"' << a << '"';
+		(out += '"').append(a) += '"';
 	else
-		out << a;
+		out += a;
 	
 	// The next token written will not be the first one on this line, so it only
 	// needs to have a single space before it.
@@ -137,5 +167,58 @@ void DataWriter::WriteToken(const string &a)
 // Output a current data as a string.
 string DataWriter::GetString() const
 {
-	return out.str();
+	return out;
+}
+
+
+
+// Write a number in the same format that a stream with a precision of 8
+// digits would.
+void DataWriter::WriteNumber(int64_t value)
+{
+	// The magnitude of the most negative number does not fit in an int64_t,
+	// so it is negated as an unsigned value instead.
+	if(value < 0)
+		out += '-';
+	WriteNumber(value < 0 ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value));
+}
+
+
+
+void DataWriter::WriteNumber(uint64_t value)
+{
+	char buffer[20];
+	char *end = buffer + sizeof(buffer);
+	out.append(FormatDigits(value, end), end);
+}
+
+
+
+void DataWriter::WriteNumber(double value)
+{
+	// Whole numbers with no more than 8 digits are written without a decimal
+	// point, just like integers. Negative zero must keep its sign, though.
+	if(value == floor(value) && fabs(value) < 1e8 && (value || !signbit(value)))
+	{
+		WriteNumber(static_cast<int64_t>(value));
+		return;
+	}
+	
+	// Anything else is formatted with the same rules that streams use.
+	char buffer[32];
+	int length = snprintf(buffer, sizeof(buffer), "%.8g", value);
+	out.append(buffer, max(0, length));
+}
+
+
+
+// If writing to a file, write the data that has been generated so far to it
+// once enough of it has accumulated.
+void DataWriter::Flush(bool force)
+{
+	if(file && (force || out.size() >= BUFFER_SIZE))
+	{
+		Files::Write(file, out);
+		out.clear();
+	}
 }
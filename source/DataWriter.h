@@ -13,10 +13,13 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #ifndef DATA_WRITER_H_
 #define DATA_WRITER_H_
 
+#include "File.h"
+
 #include <algorithm>
+#include <cstdint>
 #include <map>
-#include <sstream>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 class DataNode;
@@ -32,13 +35,15 @@ class DataWriter {
 public:
 	// Constructor, specifying the file to write.
 	// If path is empty, no file will be created, but we can use GetString().
+	// Otherwise, the data is written to a temporary file as it is generated,
+	// which replaces the given file once the writer is destroyed.
 	explicit DataWriter(const std::string &path);
 	DataWriter(const DataWriter &) = delete;
 	DataWriter(DataWriter &&) = delete;
 	DataWriter &operator=(const DataWriter &) = delete;
 	DataWriter operator=(DataWriter &&) = delete;
-	// The file is not actually saved until the destructor is called. This makes
-	// it possible to write the whole file in a single chunk.
+	// The file is not actually replaced until the destructor is called, so it
+	// is never left partly written.
 	~DataWriter();
 	
 	// The Write() function can take any number of arguments. Each argument is
@@ -64,16 +69,31 @@ public:
 	// Write a token, without writing a whole line. Use this very carefully.
 	void WriteToken(const char *a);
 	void WriteToken(const std::string &a);
-	// Write a token of any arithmetic type.
+	// Write a token of any arithmetic type. Characters are written as they
+	// are, not as numbers.
 	template <class A>
 	void WriteToken(const A &a);
 	
 	// Get a current data as a string.
 	std::string GetString() const;
 	
+	
+private:
+	// Write a number in the same format that a stream with a precision of 8
+	// digits would.
+	void WriteNumber(int64_t value);
+	void WriteNumber(uint64_t value);
+	void WriteNumber(double value);
+	// If writing to a file, write the data that has been generated so far to it
+	// once enough of it has accumulated.
+	void Flush(bool force = false);
+	
+	
 private:
 	// Save path (in UTF-8).
 	std::string path;
+	// The temporary file that the data is written to, if any.
+	File file;
 	// Current indentation level.
 	std::string indent;
 	// Before writing each token, we will write either the indentation string
@@ -82,8 +102,9 @@ private:
 	// Remember which string should be written before the next token. This is
 	// "indent" for the first token in a line and "space" for subsequent tokens.
 	const std::string *before;
-	// Compose the output in memory before writing it to file.
-	std::ostringstream out;
+	// Compose the output in memory before writing it to file. If there is a
+	// file, this only holds what has not been written to it yet.
+	std::string out;
 };
 
 
@@ -106,7 +127,17 @@ void DataWriter::WriteToken(const A &a)
 	static_assert(std::is_arithmetic<A>::value,
 		"DataWriter cannot output anything but strings and arithmetic types.");
 	
-	out << *before << a;
+	out += *before;
+	// Characters are written as themselves, just as a stream would write them.
+	if(std::is_same<A, char>::value || std::is_same<A, signed char>::value
+			|| std::is_same<A, unsigned char>::value)
+		out += static_cast<char>(a);
+	else if(std::is_floating_point<A>::value)
+		WriteNumber(static_cast<double>(a));
+	else if(std::is_signed<A>::value)
+		WriteNumber(static_cast<int64_t>(a));
+	else
+		WriteNumber(static_cast<uint64_t>(a));
 	before = &space;
 }
 
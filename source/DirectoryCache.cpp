@@ -0,0 +1,228 @@
+/* DirectoryCache.cpp
+Copyright (c) 2021 by Michael Zahniser
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "DirectoryCache.h"
+
+#include "DataFile.h"
+#include "DataNode.h"
+#include "DataWriter.h"
+#include "Files.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <ctime>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
+
+using namespace std;
+
+namespace {
+	// The contents of one directory. The names of any directories in it end
+	// in a '/', and all names are relative to the directory itself.
+	class Listing {
+	public:
+		time_t timestamp = 0;
+		vector<string> entries;
+		// Whether this listing was read from the disk rather than the cache.
+		bool isRead = false;
+		// Whether the directory was modified so recently that files might have
+		// been added to it since it was read, within the same second.
+		bool isRecent = false;
+	};
+	
+	string cachePath;
+	// The listings that were loaded from the cache file:
+	map<string, Listing> saved;
+	
+	mutex listingMutex;
+	// The listings of every directory that has been scanned:
+	map<string, Listing> listings;
+	bool isChanged = false;
+	
+	// Read the given directory, unless the given listing of it from the cache
+	// is still up to date.
+	Listing Read(const string &directory, const Listing *old, time_t now)
+	{
+		Listing listing;
+		// Some operating systems cannot find a directory whose path ends in a
+		// slash, so the slash is removed when checking its modification time.
+		string path = directory.substr(0, directory.length() - 1);
+		if(!Files::Exists(path))
+			return listing;
+		
+		listing.timestamp = Files::Timestamp(path);
+		if(old && old->timestamp == listing.timestamp)
+		{
+			listing.entries = old->entries;
+			return listing;
+		}
+		
+		for(const string &entry : Files::ListEntries(directory))
+			listing.entries.push_back(entry.substr(directory.length()));
+		listing.isRead = true;
+		listing.isRecent = (listing.timestamp >= now - 1);
+		return listing;
+	}
+	
+	// Add all the files in the given directory and the directories it contains
+	// to the given list. The listing mutex must be locked.
+	void Append(const string &directory, vector<string> &list)
+	{
+		auto it = listings.find(directory);
+		if(it == listings.end())
+			return;
+		
+		for(const string &entry : it->second.entries)
+		{
+			if(entry.back() == '/')
+				Append(directory + entry, list);
+			else
+				list.push_back(directory + entry);
+		}
+	}
+}
+
+
+
+// Load the listings that were saved in the given file, and save them there
+// again when Save() is called. Until this is called, nothing is cached
+// between launches of the game.
+void DirectoryCache::Init(const string &path)
+{
+	cachePath = path;
+	if(!Files::Exists(path))
+		return;
+	
+	DataFile file(path);
+	for(const DataNode &node : file)
+	{
+		if(node.Token(0) != "directory" || node.Size() < 3)
+			continue;
+		
+		Listing &listing = saved[node.Token(1)];
+		listing.timestamp = static_cast<time_t>(node.Value(2));
+		for(const DataNode &child : node)
+			listing.entries.push_back(child.Token(0));
+	}
+}
+
+
+
+// Scan the given directories, and every directory that they contain, in
+// parallel. Directories that have already been scanned are skipped.
+void DirectoryCache::Scan(const vector<string> &directories)
+{
+	unique_lock<mutex> lock(listingMutex);
+	deque<string> pending;
+	for(string directory : directories)
+	{
+		if(directory.empty() || directory.back() != '/')
+			directory += '/';
+		if(!listings.count(directory))
+			pending.push_back(directory);
+	}
+	if(pending.empty())
+		return;
+	
+	// Each thread takes a directory from the list of pending ones, reads it,
+	// and adds any directories that are in it to the list. The scan is done
+	// once the list is empty and no thread is still reading a directory.
+	time_t now = time(nullptr);
+	int busy = 0;
+	condition_variable condition;
+	auto work = [&pending, &busy, &condition, now]() -> void
+	{
+		unique_lock<mutex> lock(listingMutex);
+		while(true)
+		{
+			condition.wait(lock, [&pending, &busy]() -> bool { return !pending.empty() || !busy; });
+			if(pending.empty())
+				return;
+			
+			string directory = move(pending.front());
+			pending.pop_front();
+			++busy;
+			auto it = saved.find(directory);
+			const Listing *old = (it == saved.end() ? nullptr : &it->second);
+			
+			lock.unlock();
+			Listing listing = Read(directory, old, now);
+			lock.lock();
+			
+			for(const string &entry : listing.entries)
+				if(entry.back() == '/')
+					pending.push_back(directory + entry);
+			isChanged |= listing.isRead;
+			listings[directory] = move(listing);
+			--busy;
+			condition.notify_all();
+		}
+	};
+	lock.unlock();
+	
+	vector<thread> workers;
+	unsigned threadCount = max(1u, thread::hardware_concurrency());
+	for(unsigned i = 0; i < threadCount; ++i)
+		workers.emplace_back(work);
+	for(thread &worker : workers)
+		worker.join();
+}
+
+
+
+// Get a list of all regular files in the given directory or any directory
+// that it contains, recursively, in the same order as Files::RecursiveList().
+// Any of those directories that have not been scanned are scanned first.
+vector<string> DirectoryCache::RecursiveList(const string &directory)
+{
+	string root = directory;
+	if(root.empty() || root.back() != '/')
+		root += '/';
+	Scan(vector<string>(1, root));
+	
+	vector<string> list;
+	lock_guard<mutex> lock(listingMutex);
+	Append(root, list);
+	return list;
+}
+
+
+
+// Save the listings of every directory that has been scanned, if any of
+// them are different from the ones that were loaded.
+void DirectoryCache::Save()
+{
+	lock_guard<mutex> lock(listingMutex);
+	if(cachePath.empty() || !isChanged)
+		return;
+	
+	// Directories that do not exist are not saved, because they must be
+	// checked for again anyways, and neither are recently modified ones.
+	DataWriter out(cachePath);
+	for(const auto &it : listings)
+	{
+		if(!it.second.timestamp || it.second.isRecent)
+			continue;
+		
+		out.Write("directory", it.first, static_cast<int64_t>(it.second.timestamp));
+		out.BeginChild();
+		{
+			for(const string &entry : it.second.entries)
+				out.Write(entry);
+		}
+		out.EndChild();
+	}
+	isChanged = false;
+}
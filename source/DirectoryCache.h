@@ -0,0 +1,51 @@
+/* DirectoryCache.h
+Copyright (c) 2021 by Michael Zahniser
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#ifndef DIRECTORY_CACHE_H_
+#define DIRECTORY_CACHE_H_
+
+#include <string>
+#include <vector>
+
+
+
+// Class for listing the files in the game's resource directories. Directories
+// are scanned by several threads at once, and each directory's listing is kept
+// in memory, so listing the same directory again does not read it from the
+// disk. If a cache file is given, the listings are also saved to it, along with
+// the modification time of each directory. Because a directory's modification
+// time changes whenever anything is added to it or removed from it, a directory
+// whose time has not changed need not be read again the next time the game is
+// launched, which saves checking the type of every file in it.
+class DirectoryCache {
+public:
+	// Load the listings that were saved in the given file, and save them there
+	// again when Save() is called. Until this is called, nothing is cached
+	// between launches of the game.
+	static void Init(const std::string &path);
+	
+	// Scan the given directories, and every directory that they contain, in
+	// parallel. Directories that have already been scanned are skipped.
+	static void Scan(const std::vector<std::string> &directories);
+	// Get a list of all regular files in the given directory or any directory
+	// that it contains, recursively, in the same order as Files::RecursiveList().
+	// Any of those directories that have not been scanned are scanned first.
+	static std::vector<std::string> RecursiveList(const std::string &directory);
+	
+	// Save the listings of every directory that has been scanned, if any of
+	// them are different from the ones that were loaded.
+	static void Save();
+};
+
+
+
+#endif
@@ -138,7 +138,10 @@ void DrawList::Push(const Body &body, Point pos, Point blur, double cloak, doubl
 {
 	SpriteShader::Item item;
 	
+	// Sprites that are still being loaded are not drawn.
 	item.texture = body.GetSprite()->Texture(isHighDPI);
+	if(!item.texture)
+		return;
 	item.frame = body.GetFrame(step);
 	item.frameCount = body.GetSprite()->Frames();
 	
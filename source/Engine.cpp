@@ -45,9 +45,9 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "PointerShader.h"
 #include "Politics.h"
 #include "Preferences.h"
+#include "PrimitiveDrawList.h"
 #include "Projectile.h"
 #include "Random.h"
-#include "RingShader.h"
 #include "Screen.h"
 #include "Ship.h"
 #include "ShipEvent.h"
@@ -894,6 +894,9 @@ void Engine::Draw() const
 	draw[drawTickTock].Draw();
 	batchDraw[drawTickTock].Draw();
 	
+	// The status rings, and later the target crosshairs, are each drawn with a
+	// single command.
+	PrimitiveDrawList shapes;
 	for(const auto &it : statuses)
 	{
 		static const Color color[8] = {
@@ -909,13 +912,14 @@ void Engine::Draw() const
 		Point pos = it.position * zoom;
 		double radius = it.radius * zoom;
 		if(it.outer > 0.)
-			RingShader::Draw(pos, radius + 3., 1.5f, it.outer, color[it.type], 0.f, it.angle);
+			shapes.AddRing(pos, radius + 3., 1.5f, it.outer, color[it.type], 0.f, it.angle);
 		double dashes = (it.type >= 2) ? 0. : 20. * min(1., zoom);
 		if(it.inner > 0.)
-			RingShader::Draw(pos, radius, 1.5f, it.inner, color[3 + it.type], dashes, it.angle);
+			shapes.AddRing(pos, radius, 1.5f, it.inner, color[3 + it.type], dashes, it.angle);
 		if(it.disabled > 0.)
-			RingShader::Draw(pos, radius, 1.5f, it.disabled, color[6 + it.type], dashes, it.angle);
+			shapes.AddRing(pos, radius, 1.5f, it.disabled, color[6 + it.type], dashes, it.angle);
 	}
+	shapes.Draw();
 	
 	// Draw the flagship highlight, if any.
 	if(highlightSprite)
@@ -949,20 +953,20 @@ void Engine::Draw() const
 	}
 	
 	// Draw crosshairs around anything that is targeted.
+	shapes.Clear();
 	for(const Target &target : targets)
 	{
 		Angle a = target.angle;
 		Angle da(360. / target.count);
 		
-		PointerShader::Bind();
 		for(int i = 0; i < target.count; ++i)
 		{
-			PointerShader::Add(target.center * zoom, a.Unit(), 12.f, 14.f, -target.radius * zoom,
+			shapes.AddPointer(target.center * zoom, a.Unit(), 12.f, 14.f, -target.radius * zoom,
 				Radar::GetColor(target.type));
 			a += da;
 		}
-		PointerShader::Unbind();
 	}
+	shapes.Draw();
 	
 	// Draw the heads-up display.
 	interface->Draw(info);
@@ -1037,10 +1041,6 @@ void Engine::Draw() const
 	// Draw escort status.
 	escorts.Draw(interface->GetBox("escorts"));
 	
-	// Upload any preloaded sprites that are now available. This is to avoid
-	// filling the entire backlog of sprites before landing on a planet.
-	GameData::Progress();
-	
 	if(Preferences::Has("Show CPU / GPU load"))
 	{
 		string loadString = to_string(lround(load * 100.)) + "% CPU";
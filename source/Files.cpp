@@ -44,6 +44,9 @@ namespace {
 	
 	mutex errorMutex;
 	File errorLog;
+	// Errors logged on a thread that is collecting them are kept here instead.
+	thread_local bool isCollecting = false;
+	thread_local vector<string> collected;
 	
 	// Convert windows-style directory separators ('\\') to standard '/'.
 #if defined _WIN32
@@ -349,6 +352,67 @@ vector<string> Files::ListDirectories(string directory)
 
 
 
+// Get a list of all regular files and directories in the given directory, in
+// the order the operating system lists them. Directory names end in a '/'.
+vector<string> Files::ListEntries(string directory)
+{
+	if(directory.empty() || directory.back() != '/')
+		directory += '/';
+	
+	vector<string> list;
+	
+#if defined _WIN32
+	WIN32_FIND_DATAW ffd;
+	HANDLE hFind = FindFirstFileW(ToUTF16(directory + '*').c_str(), &ffd);
+	if(hFind == INVALID_HANDLE_VALUE)
+		return list;
+	
+	do {
+		if(!ffd.cFileName || ffd.cFileName[0] == '.')
+			continue;
+		
+		if(!(ffd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY))
+			list.push_back(directory + ToUTF8(ffd.cFileName));
+		else
+			list.push_back(directory + ToUTF8(ffd.cFileName) + '/');
+	} while(FindNextFileW(hFind, &ffd));
+	
+	FindClose(hFind);
+#else
+	DIR *dir = opendir(directory.c_str());
+	if(!dir)
+		return list;
+	
+	while(true)
+	{
+		dirent *ent = readdir(dir);
+		if(!ent)
+			break;
+		// Skip dotfiles (including "." and "..").
+		if(ent->d_name[0] == '.')
+			continue;
+		
+		string name = directory + ent->d_name;
+		// Don't assume that this operating system's implementation of dirent
+		// includes the t_type field; in particular, on Windows it will not.
+		struct stat buf;
+		stat(name.c_str(), &buf);
+		bool isRegularFile = S_ISREG(buf.st_mode);
+		bool isDirectory = S_ISDIR(buf.st_mode);
+		
+		if(isRegularFile)
+			list.push_back(name);
+		else if(isDirectory)
+			list.push_back(name + '/');
+	}
+	
+	closedir(dir);
+#endif
+	return list;
+}
+
+
+
 vector<string> Files::RecursiveList(const string &directory)
 {
 	vector<string> list;
@@ -441,6 +505,22 @@ time_t Files::Timestamp(const string &filePath)
 
 
 
+size_t Files::Size(const string &filePath)
+{
+#if defined _WIN32
+	struct _stat buf;
+	if(_wstat(ToUTF16(filePath).c_str(), &buf))
+		return 0;
+#else
+	struct stat buf;
+	if(stat(filePath.c_str(), &buf))
+		return 0;
+#endif
+	return buf.st_size;
+}
+
+
+
 void Files::Copy(const string &from, const string &to)
 {
 #if defined _WIN32
@@ -474,6 +554,17 @@ void Files::Delete(const string &filePath)
 
 
 
+void Files::CreateFolder(const string &path)
+{
+#if defined _WIN32
+	CreateDirectoryW(ToUTF16(path).c_str(), nullptr);
+#else
+	mkdir(path.c_str(), 0755);
+#endif
+}
+
+
+
 // Get the filename from a path.
 string Files::Name(const string &path)
 {
@@ -557,8 +648,32 @@ void Files::Write(FILE *file, const string &data)
 
 
 
+// Write the data exactly as given, without converting any newlines on
+// systems that would otherwise do so (i.e. Windows).
+void Files::WriteBinary(const string &path, const string &data)
+{
+#if defined _WIN32
+	FILE *file = _wfopen(ToUTF16(path).c_str(), L"wb");
+#else
+	FILE *file = fopen(path.c_str(), "wb");
+#endif
+	if(!file)
+		return;
+	
+	Write(file, data);
+	fclose(file);
+}
+
+
+
 void Files::LogError(const string &message)
 {
+	if(isCollecting)
+	{
+		collected.push_back(message);
+		return;
+	}
+	
 	lock_guard<mutex> lock(errorMutex);
 	cerr << message << endl;
 	if(!errorLog)
@@ -568,3 +683,24 @@ void Files::LogError(const string &message)
 	fwrite("\n", 1, 1, errorLog);
 	fflush(errorLog);
 }
+
+
+
+// Keep any errors that are logged on this thread, instead of logging them,
+// until TakeErrors() is called. This way, errors from work done in parallel
+// can be logged in the same order as if it were done one piece at a time.
+void Files::CollectErrors()
+{
+	isCollecting = true;
+}
+
+
+
+// Stop collecting errors on this thread, and get the ones that were collected.
+vector<string> Files::TakeErrors()
+{
+	isCollecting = false;
+	vector<string> result;
+	result.swap(collected);
+	return result;
+}
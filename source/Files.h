@@ -43,6 +43,9 @@ public:
 	static std::vector<std::string> List(std::string directory);
 	// Get a list of any directories in the given directory.
 	static std::vector<std::string> ListDirectories(std::string directory);
+	// Get a list of all regular files and directories in the given directory, in
+	// the order the operating system lists them. Directory names end in a '/'.
+	static std::vector<std::string> ListEntries(std::string directory);
 	// Get a list of all regular files in the given directory or any directory
 	// that it contains, recursively.
 	static std::vector<std::string> RecursiveList(const std::string &directory);
@@ -50,9 +53,11 @@ public:
 	
 	static bool Exists(const std::string &filePath);
 	static std::time_t Timestamp(const std::string &filePath);
+	static size_t Size(const std::string &filePath);
 	static void Copy(const std::string &from, const std::string &to);
 	static void Move(const std::string &from, const std::string &to);
 	static void Delete(const std::string &filePath);
+	static void CreateFolder(const std::string &path);
 	
 	// Get the filename from a path.
 	static std::string Name(const std::string &path);
@@ -66,8 +71,17 @@ public:
 	static std::string Read(FILE *file);
 	static void Write(const std::string &path, const std::string &data);
 	static void Write(FILE *file, const std::string &data);
+	// Write the data exactly as given, without converting any newlines on
+	// systems that would otherwise do so (i.e. Windows).
+	static void WriteBinary(const std::string &path, const std::string &data);
 	
 	static void LogError(const std::string &message);
+	// Keep any errors that are logged on this thread, instead of logging them,
+	// until TakeErrors() is called. This way, errors from work done in parallel
+	// can be logged in the same order as if it were done one piece at a time.
+	static void CollectErrors();
+	// Stop collecting errors on this thread, and get the ones that were collected.
+	static std::vector<std::string> TakeErrors();
 };
 
 
@@ -17,6 +17,8 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "Color.h"
 #include "Command.h"
 #include "Conversation.h"
+#include "DataCache.h"
+#include "DirectoryCache.h"
 #include "DataFile.h"
 #include "DataNode.h"
 #include "DataWriter.h"
@@ -31,6 +33,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "text/Gettext.h"
 #include "Government.h"
 #include "Hazard.h"
+#include "ImageCache.h"
 #include "ImageSet.h"
 #include "Interface.h"
 #include "Languages.h"
@@ -46,6 +49,8 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "Planet.h"
 #include "PointerShader.h"
 #include "Politics.h"
+#include "PrimitiveShader.h"
+#include "Profiler.h"
 #include "Random.h"
 #include "RingShader.h"
 #include "Ship.h"
@@ -56,13 +61,19 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "StarField.h"
 #include "StartConditions.h"
 #include "System.h"
+#include "SystemGrid.h"
 #include "Test.h"
 #include "TestData.h"
 
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
 #include <iostream>
 #include <map>
+#include <mutex>
 #include <set>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -89,6 +100,7 @@ namespace {
 	Set<Planet> planets;
 	Set<Ship> ships;
 	Set<System> systems;
+	SystemGrid systemGrid;
 	Set<Test> tests;
 	Set<TestData> testDataSets;
 	set<double> neighborDistances;
@@ -109,6 +121,8 @@ namespace {
 	
 	Trade trade;
 	map<const System *, map<string, int>> purchases;
+	// This is incremented every time the universe changes.
+	int revision = 0;
 	
 	map<const Sprite *, T_> landingMessages;
 	map<const Sprite *, double> solarPower;
@@ -128,10 +142,31 @@ namespace {
 	
 	vector<string> sources;
 	map<const Sprite *, shared_ptr<ImageSet>> deferred;
+	// Deferred sprites that have been loaded, and how many frames it has been
+	// since each was last drawn. Sprites can be preloaded from any thread.
 	map<const Sprite *, int> preloaded;
+	mutex preloadMutex;
+	
+	// If the deferred sprites use more texture memory than this, any that have
+	// not been drawn recently are unloaded, oldest first.
+	const size_t DEFERRED_SPRITE_MEMORY = static_cast<size_t>(512) << 20;
+	// Sprites that have been drawn within this many frames are never unloaded.
+	const int MIN_SPRITE_AGE = 60;
 	
 	const Government *playerGovernment = nullptr;
 	
+	// Find which source folder (the game itself or a plugin) the given file is
+	// in. Because plugins may be inside the game's folder, use the longest.
+	const string &SourceOf(const string &path)
+	{
+		static const string NONE;
+		const string *result = &NONE;
+		for(const string &source : sources)
+			if(source.size() > result->size() && !path.compare(0, source.size(), source))
+				result = &source;
+		return *result;
+	}
+	
 	// TODO (C++14): make these 3 methods generic lambdas visible only to the CheckReferences method.
 	// Log a warning for an "undefined" class object that was never loaded from disk.
 	void Warn(const string &noun, const string &name)
@@ -149,6 +184,58 @@ namespace {
 		
 		return true;
 	}
+	// Parse the given number of data files on a pool of worker threads. As soon
+	// as each file has been parsed, it is passed to the given function on this
+	// thread, in order, so data files that are loaded later can still override
+	// earlier ones.
+	void ParseDataFiles(size_t count, const function<void(size_t, DataFile &)> &parse,
+		const function<void(size_t, const DataFile &)> &apply)
+	{
+		vector<DataFile> files(count);
+		// Any warnings printed while parsing a file are logged just before it
+		// is applied, so they are in the same order as if it were parsed then.
+		vector<vector<string>> errors(count);
+		vector<char> isParsed(count, false);
+		atomic<size_t> next(0);
+		mutex parsedMutex;
+		condition_variable parsedCondition;
+		
+		auto work = [&]() -> void
+		{
+			for(size_t i = next++; i < count; i = next++)
+			{
+				Files::CollectErrors();
+				parse(i, files[i]);
+				errors[i] = Files::TakeErrors();
+				
+				lock_guard<mutex> lock(parsedMutex);
+				isParsed[i] = true;
+				parsedCondition.notify_all();
+			}
+		};
+		size_t threadCount = min<size_t>(max(1u, thread::hardware_concurrency()), count);
+		vector<thread> workers;
+		for(size_t i = 0; i < threadCount; ++i)
+			workers.emplace_back(work);
+		
+		for(size_t i = 0; i < count; ++i)
+		{
+			{
+				unique_lock<mutex> lock(parsedMutex);
+				parsedCondition.wait(lock, [&isParsed, i]() -> bool { return isParsed[i]; });
+			}
+			for(const string &error : errors[i])
+				Files::LogError(error);
+			errors[i].clear();
+			apply(i, files[i]);
+			// Each file's nodes are no longer needed once it has been applied.
+			files[i] = DataFile();
+		}
+		
+		for(thread &worker : workers)
+			worker.join();
+	}
+	
 	// Set the name of an "undefined" class object, so that it can be written to the player's save.
 	template <class Type>
 	void NameAndWarn(const string &noun, pair<const string, Type> &it)
@@ -166,6 +253,9 @@ bool GameData::BeginLoad(const char * const *argv)
 	bool printTests = false;
 	bool printWeapons = false;
 	bool debugMode = false;
+	bool useDataCache = false;
+	bool useImageCache = false;
+	bool useDirectoryCache = false;
 	for(const char * const *it = argv + 1; *it; ++it)
 	{
 		if((*it)[0] == '-')
@@ -179,17 +269,46 @@ bool GameData::BeginLoad(const char * const *argv)
 				printTests = true;
 			if(arg == "-d" || arg == "--debug")
 				debugMode = true;
+			if(arg == "--data-cache")
+				useDataCache = true;
+			if(arg == "--image-cache")
+				useImageCache = true;
+			if(arg == "--directory-cache")
+				useDirectoryCache = true;
+			if(arg == "--profile-startup")
+				Profiler::Enable();
 			continue;
 		}
 	}
+	// Time each step of loading, if the startup is being profiled.
+	Profiler::Span phase("Files::Init");
 	Files::Init(argv);
 	
 	// Initialize the list of "source" folders based on any active plugins.
+	phase.Next("LoadSources");
 	LoadSources();
 	
+	// Scan all the directories that resources are loaded from at once, so
+	// that they can be read in parallel. If the directory cache is enabled,
+	// directories that have not changed since it was saved are not read again.
+	phase.Next("Scan directories");
+	if(useDirectoryCache)
+		DirectoryCache::Init(Files::Config() + "directory cache.txt");
+	vector<string> directories;
+	for(const string &source : sources)
+		for(const char *directory : {"images/", "data/", "sounds/"})
+			directories.push_back(source + directory);
+	DirectoryCache::Scan(directories);
+	
+	// If the image cache is enabled, sprites whose images have not changed
+	// since they were cached do not need to be decoded again.
+	if(useImageCache)
+		ImageCache::Init(Files::Config() + "image cache/");
+	
 	// Now, read all the images in all the path directories. For each unique
 	// name, only remember one instance, letting things on the higher priority
 	// paths override the default images.
+	phase.Next("FindImages");
 	map<string, shared_ptr<ImageSet>> images = FindImages();
 	
 	// From the name, strip out any frame number, plus the extension.
@@ -201,39 +320,101 @@ bool GameData::BeginLoad(const char * const *argv)
 		
 		// Check that the image set is complete.
 		it.second->Check();
-		// For landscapes, remember all the source files but don't load them yet.
+		// For sprites that are only loaded once they are drawn, remember all
+		// the source files, but only read the dimensions of the images now.
 		if(ImageSet::IsDeferred(it.first))
+		{
+			it.second->Defer();
 			deferred[SpriteSet::Get(it.first)] = it.second;
-		else
-			spriteQueue.Add(it.second);
+		}
+		spriteQueue.Add(it.second);
 	}
 	
 	// Generate a catalog of music files.
+	phase.Next("Music::Init");
 	Music::Init(sources);
 	
 	// Add font and config files.
+	phase.Next("FontSet::Add");
 	for(const string &source : sources)
 		FontSet::Add(source + "fonts/");
 	
 	// Search all message catalogs.
+	phase.Next("Languages::Init");
 	Languages::Init(sources);
 	
+	// Iterate through the paths starting with the last directory given. That
+	// is, things in folders near the start of the path have the ability to
+	// override things in folders later in the path.
+	phase.Next("List data files");
+	vector<string> dataFiles;
 	for(const string &source : sources)
+		for(const string &path : DirectoryCache::RecursiveList(source + "data/"))
+			if(path.length() >= 4 && !path.compare(path.length() - 4, 4, ".txt"))
+				dataFiles.push_back(path);
+	// Every directory that is listed during loading has been scanned by now.
+	DirectoryCache::Save();
+	
+	// If the data cache is enabled, any files that have not changed since it
+	// was written are loaded from it instead of being parsed. If any file has
+	// changed, been added, or been removed, the whole cache is written again.
+	unique_ptr<DataCache> cache;
+	vector<char> isCached(dataFiles.size(), false);
+	vector<int64_t> timestamps(dataFiles.size(), 0);
+	vector<uint64_t> sizes(dataFiles.size(), 0);
+	bool updateCache = false;
+	if(useDataCache)
 	{
-		// Iterate through the paths starting with the last directory given. That
-		// is, things in folders near the start of the path have the ability to
-		// override things in folders later in the path.
-		vector<string> dataFiles = Files::RecursiveList(source + "data/");
-		for(const string &path : dataFiles)
-			LoadFile(path, debugMode);
+		cache.reset(new DataCache(Files::Config() + "data cache"));
+		for(size_t i = 0; i < dataFiles.size(); ++i)
+		{
+			isCached[i] = cache->IsCurrent(dataFiles[i]);
+			updateCache |= !isCached[i];
+		}
+		updateCache |= (cache->Count() != dataFiles.size());
+	}
+	
+	// Parsing each file does not depend on any other file, so they can be
+	// parsed in parallel, but the data in them must be applied in order.
+	phase.Next("Parse data files");
+	ParseDataFiles(dataFiles.size(),
+		[&dataFiles, &isCached, &timestamps, &sizes, &cache](size_t i, DataFile &data) -> void
+		{
+			Profiler::Span span(dataFiles[i], "parse", SourceOf(dataFiles[i]));
+			// The file's timestamp and size are read before the file itself, so
+			// that if it is changed in between, the cache entry will not match
+			// it and it will be parsed again next time. A file that changed
+			// since the cache was checked is parsed now instead.
+			if(cache)
+			{
+				timestamps[i] = Files::Timestamp(dataFiles[i]);
+				sizes[i] = Files::Size(dataFiles[i]);
+				isCached[i] = isCached[i] && cache->IsCurrent(dataFiles[i], timestamps[i], sizes[i]);
+			}
+			if(!isCached[i] || !cache->Load(dataFiles[i], data))
+				data.Load(dataFiles[i]);
+		},
+		[&dataFiles, &timestamps, &sizes, &cache, updateCache, debugMode](size_t i, const DataFile &data) -> void
+		{
+			Profiler::Span span(dataFiles[i], "apply", SourceOf(dataFiles[i]));
+			LoadFile(dataFiles[i], data, debugMode);
+			if(updateCache)
+				cache->Add(dataFiles[i], timestamps[i], sizes[i], data);
+		});
+	if(cache)
+	{
+		phase.Next("Save data cache");
+		cache->Save();
 	}
 	
 	// Now that all data is loaded, update the neighbor lists and other
 	// system information. Make sure that the default jump range is among the
 	// neighbor distances to be updated.
+	phase.Next("UpdateSystems");
 	AddJumpRange(System::DEFAULT_NEIGHBOR_DISTANCE);
 	UpdateSystems();
 	// And, update the ships with the outfits we've now finished loading.
+	phase.Next("FinishLoading");
 	for(auto &&it : ships)
 		it.second.FinishLoading(true);
 	for(auto &&it : persons)
@@ -248,6 +429,7 @@ bool GameData::BeginLoad(const char * const *argv)
 	);
 	
 	// Store the current state, to revert back to later.
+	phase.Next("Store default state");
 	defaultFleets = fleets;
 	defaultGovernments = governments;
 	defaultPlanets = planets;
@@ -275,6 +457,8 @@ bool GameData::BeginLoad(const char * const *argv)
 // planets) are written to the player's save and need a name to prevent data loss.
 void GameData::CheckReferences()
 {
+	Profiler::Span span("CheckReferences");
+	
 	// Parse all GameEvents for object definitions.
 	auto deferred = map<string, set<string>>{};
 	for(auto &&it : events)
@@ -371,6 +555,7 @@ void GameData::LoadShaders(bool useShaderSwizzle)
 	RingShader::Init();
 	SpriteShader::Init(useShaderSwizzle);
 	BatchShader::Init();
+	PrimitiveShader::Init();
 	
 	background.Init(16384, 4096);
 }
@@ -391,6 +576,10 @@ double GameData::Progress()
 				if(path.compare(0, 5, "land/") != 0)
 					Files::LogError("Warning: image \"" + path + "\" is referred to, but has no pixels.");
 			initiallyLoaded = true;
+			
+			// Startup is now complete, so there is nothing else to profile.
+			if(Profiler::IsEnabled())
+				Profiler::Finish(Files::Config() + "startup profile.json");
 		}
 	}
 	return progress;
@@ -405,8 +594,9 @@ bool GameData::IsLoaded()
 
 
 
-// Begin loading a sprite that was previously deferred. Currently this is
-// done with all landscapes to speed up the program's startup.
+// Begin loading a sprite that was previously deferred. All sprites that do
+// not have collision masks are deferred to speed up the program's startup,
+// and are loaded automatically the first time they are drawn.
 void GameData::Preload(const Sprite *sprite)
 {
 	// Make sure this sprite actually is one that uses deferred loading.
@@ -414,40 +604,45 @@ void GameData::Preload(const Sprite *sprite)
 	if(!sprite || dit == deferred.end())
 		return;
 	
-	// If this sprite is one of the currently loaded ones, there is no need to
-	// load it again. But, make note of the fact that it is the most recently
-	// asked-for sprite.
-	map<const Sprite *, int>::iterator pit = preloaded.find(sprite);
-	if(pit != preloaded.end())
+	// If this sprite is already loaded or being loaded, there is no need to
+	// load it again.
+	lock_guard<mutex> lock(preloadMutex);
+	if(preloaded.emplace(sprite, 0).second)
+		spriteQueue.Add(dit->second);
+}
+
+
+
+// Upload any deferred sprites that have finished loading, and unload the
+// least recently drawn ones if they are using too much texture memory. This
+// should be called once per frame.
+void GameData::StepSprites()
+{
+	Progress();
+	
+	// Find out how long it has been since each sprite was drawn, and how much
+	// texture memory is in use.
+	lock_guard<mutex> lock(preloadMutex);
+	size_t memory = 0;
+	vector<pair<int, const Sprite *>> unused;
+	for(auto &it : preloaded)
 	{
-		for(pair<const Sprite * const, int> &it : preloaded)
-			if(it.second < pit->second)
-				++it.second;
-		
-		pit->second = 0;
-		return;
+		it.second = it.first->WasUsed() ? 0 : it.second + 1;
+		memory += it.first->TextureMemory();
+		// Sprites that are still being loaded cannot be unloaded yet.
+		if(it.second >= MIN_SPRITE_AGE && it.first->TextureMemory())
+			unused.emplace_back(it.second, it.first);
 	}
+	if(memory <= DEFERRED_SPRITE_MEMORY)
+		return;
 	
-	// This sprite is not currently preloaded. Check to see whether we already
-	// have the maximum number of sprites loaded, in which case the oldest one
-	// must be unloaded to make room for this one.
-	const string &name = sprite->Name();
-	pit = preloaded.begin();
-	while(pit != preloaded.end())
+	sort(unused.begin(), unused.end());
+	for(auto it = unused.rbegin(); it != unused.rend() && memory > DEFERRED_SPRITE_MEMORY; ++it)
 	{
-		++pit->second;
-		if(pit->second >= 20)
-		{
-			spriteQueue.Unload(name);
-			pit = preloaded.erase(pit);
-		}
-		else
-			++pit;
+		memory -= it->second->TextureMemory();
+		spriteQueue.Unload(it->second->Name());
+		preloaded.erase(it->second);
 	}
-	
-	// Now, load all the files for this sprite.
-	preloaded[sprite] = 0;
-	spriteQueue.Add(dit->second);
 }
 
 
@@ -474,6 +669,7 @@ void GameData::Revert()
 	governments.Revert(defaultGovernments);
 	planets.Revert(defaultPlanets);
 	systems.Revert(defaultSystems);
+	systemGrid.Build(systems);
 	galaxies.Revert(defaultGalaxies);
 	shipSales.Revert(defaultShipSales);
 	outfitSales.Revert(defaultOutfitSales);
@@ -482,6 +678,7 @@ void GameData::Revert()
 	
 	politics.Reset();
 	purchases.clear();
+	++revision;
 }
 
 
@@ -645,6 +842,7 @@ void GameData::Change(const DataNode &node)
 		systems.Get(node.Token(1))->Unlink(systems.Get(node.Token(2)));
 	else
 		node.PrintTrace("Invalid \"event\" data:");
+	++revision;
 }
 
 
@@ -653,13 +851,24 @@ void GameData::Change(const DataNode &node)
 // This must be done any time that a change creates or moves a system.
 void GameData::UpdateSystems()
 {
+	systemGrid.Build(systems);
 	for(auto &it : systems)
 	{
 		// Skip systems that have no name.
 		if(it.first.empty() || it.second.Name().empty())
 			continue;
-		it.second.UpdateSystem(systems, neighborDistances);
+		it.second.UpdateSystem(systemGrid, neighborDistances);
 	}
+	++revision;
+}
+
+
+
+// Get a number that changes whenever the universe is changed, so anything
+// computed from the planets and systems can tell that it is out of date.
+int GameData::Revision()
+{
+	return revision;
 }
 
 
@@ -846,6 +1055,14 @@ const Set<System> &GameData::Systems()
 
 
 
+// Look up systems by their position on the map.
+const SystemGrid &GameData::SystemLocations()
+{
+	return systemGrid;
+}
+
+
+
 const Government *GameData::PlayerGovernment()
 {
 	return playerGovernment;
@@ -1054,13 +1271,8 @@ void GameData::LoadSources()
 
 
 
-void GameData::LoadFile(const string &path, bool debugMode)
+void GameData::LoadFile(const string &path, const DataFile &data, bool debugMode)
 {
-	// This is an ordinary file. Check to see if it is an image.
-	if(path.length() < 4 || path.compare(path.length() - 4, 4, ".txt"))
-		return;
-	
-	DataFile data(path);
 	if(debugMode)
 		Files::LogError("Parsing: " + path);
 	
@@ -1195,7 +1407,7 @@ map<string, shared_ptr<ImageSet>> GameData::FindImages()
 		string directoryPath = source + "images/";
 		size_t start = directoryPath.size();
 		
-		vector<string> imageFiles = Files::RecursiveList(directoryPath);
+		vector<string> imageFiles = DirectoryCache::RecursiveList(directoryPath);
 		for(const string &path : imageFiles)
 			if(ImageSet::IsImage(path))
 			{
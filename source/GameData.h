@@ -24,6 +24,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 
 class Color;
 class Conversation;
+class DataFile;
 class DataNode;
 class DataWriter;
 class Date;
@@ -48,6 +49,7 @@ class Sprite;
 class StarField;
 class StartConditions;
 class System;
+class SystemGrid;
 class Test;
 class TestData;
 namespace Gettext {
@@ -72,9 +74,14 @@ public:
 	static double Progress();
 	// Whether initial game loading is complete (sprites and audio are loaded).
 	static bool IsLoaded();
-	// Begin loading a sprite that was previously deferred. Currently this is
-	// done with all landscapes to speed up the program's startup.
+	// Begin loading a sprite that was previously deferred. All sprites that do
+	// not have collision masks are deferred to speed up the program's startup,
+	// and are loaded automatically the first time they are drawn.
 	static void Preload(const Sprite *sprite);
+	// Upload any deferred sprites that have finished loading, and unload the
+	// least recently drawn ones if they are using too much texture memory. This
+	// should be called once per frame.
+	static void StepSprites();
 	static void FinishLoading();
 	
 	// Get the list of resource sources (i.e. plugin folders).
@@ -93,6 +100,9 @@ public:
 	// Update the neighbor lists and other information for all the systems.
 	// This must be done any time that a change creates or moves a system.
 	static void UpdateSystems();
+	// Get a number that changes whenever the universe is changed, so anything
+	// computed from the planets and systems can tell that it is out of date.
+	static int Revision();
 	static void AddJumpRange(double neighborDistance);
 	
 	// Re-activate any special persons that were created previously but that are
@@ -121,6 +131,8 @@ public:
 	static const Set<Ship> &Ships();
 	static const Set<Sale<Ship>> &Shipyards();
 	static const Set<System> &Systems();
+	// Look up systems by their position on the map.
+	static const SystemGrid &SystemLocations();
 	static const Set<Test> &Tests();
 	static const Set<TestData> &TestDataSets();
 	
@@ -154,7 +166,7 @@ public:
 	
 private:
 	static void LoadSources();
-	static void LoadFile(const std::string &path, bool debugMode);
+	static void LoadFile(const std::string &path, const DataFile &data, bool debugMode);
 	static std::map<std::string, std::shared_ptr<ImageSet>> FindImages();
 	
 	static void PrintShipTable();
@@ -239,7 +239,7 @@ bool HailPanel::KeyDown(SDL_Keycode key, Uint16 mod, const Command &command, boo
 		if(GameData::GetPolitics().HasDominated(planet))
 		{
 			GameData::GetPolitics().DominatePlanet(planet, false);
-			player.Conditions().erase("tribute: " + planet->TrueName());
+			player.Conditions().Erase("tribute: " + planet->TrueName());
 			message = T("Thank you for granting us our freedom!");
 		}
 		else
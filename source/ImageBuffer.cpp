@@ -19,6 +19,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include <jpeglib.h>
 
 #include <cstdio>
+#include <cstring>
 #include <vector>
 
 using namespace std;
@@ -26,6 +27,8 @@ using namespace std;
 namespace {
 	bool ReadPNG(const string &path, ImageBuffer &buffer, int frame);
 	bool ReadJPG(const string &path, ImageBuffer &buffer, int frame);
+	bool ReadPNGSize(const string &path, int &width, int &height);
+	bool ReadJPGSize(const string &path, int &width, int &height);
 	void Premultiply(ImageBuffer &buffer, int frame, int additive);
 }
 
@@ -122,17 +125,29 @@ uint32_t *ImageBuffer::Begin(int y, int frame)
 
 void ImageBuffer::ShrinkToHalfSize()
 {
-	ImageBuffer result(frames);
+	ImageBuffer result;
+	ShrinkToHalfSize(result);
+	swap(width, result.width);
+	swap(height, result.height);
+	swap(pixels, result.pixels);
+}
+
+
+
+// Store a copy of this image, reduced to half size, in the given buffer.
+void ImageBuffer::ShrinkToHalfSize(ImageBuffer &result) const
+{
+	result.Clear(frames);
 	result.Allocate(width / 2, height / 2);
 	
-	unsigned char *begin = reinterpret_cast<unsigned char *>(pixels);
+	const unsigned char *begin = reinterpret_cast<const unsigned char *>(pixels);
 	unsigned char *out = reinterpret_cast<unsigned char *>(result.pixels);
 	// Loop through every line of every frame of the buffer.
 	for(int y = 0; y < result.height * frames; ++y)
 	{
-		unsigned char *aIt = begin + (4 * width) * (2 * y);
-		unsigned char *aEnd = aIt + 4 * 2 * result.width;
-		unsigned char *bIt = begin + (4 * width) * (2 * y + 1);
+		const unsigned char *aIt = begin + (4 * width) * (2 * y);
+		const unsigned char *aEnd = aIt + 4 * 2 * result.width;
+		const unsigned char *bIt = begin + (4 * width) * (2 * y + 1);
 		for( ; aIt != aEnd; aIt += 4, bIt += 4)
 		{
 			for(int channel = 0; channel < 4; ++channel, ++aIt, ++bIt, ++out)
@@ -140,9 +155,6 @@ void ImageBuffer::ShrinkToHalfSize()
 					+ static_cast<unsigned>(aIt[4]) + static_cast<unsigned>(bIt[4]) + 2) / 4;
 		}
 	}
-	swap(width, result.width);
-	swap(height, result.height);
-	swap(pixels, result.pixels);
 }
 
 
@@ -185,6 +197,20 @@ bool ImageBuffer::Read(const string &path, int frame)
 
 
 
+// Read only the dimensions of an image, without decoding it. Return false
+// if it is not a supported image format.
+bool ImageBuffer::ReadSize(const string &path, int &width, int &height)
+{
+	string extension = Files::Extension(path);
+	if(extension == ".png" || extension == ".PNG")
+		return ReadPNGSize(path, width, height);
+	if(extension == ".jpg" || extension == ".JPG")
+		return ReadJPGSize(path, width, height);
+	return false;
+}
+
+
+
 namespace {
 	bool ReadPNG(const string &path, ImageBuffer &buffer, int frame)
 	{
@@ -306,6 +332,52 @@ namespace {
 	
 	
 	
+	// A PNG file always begins with its signature, followed by the header
+	// chunk, whose first fields are the image's width and height.
+	bool ReadPNGSize(const string &path, int &width, int &height)
+	{
+		File file(path);
+		if(!file)
+			return false;
+		
+		unsigned char header[24];
+		if(fread(header, 1, sizeof(header), file) != sizeof(header) || png_sig_cmp(header, 0, 8)
+				|| memcmp(header + 12, "IHDR", 4))
+			return false;
+		
+		// The dimensions are stored in big-endian byte order.
+		width = (header[16] << 24) | (header[17] << 16) | (header[18] << 8) | header[19];
+		height = (header[20] << 24) | (header[21] << 16) | (header[22] << 8) | header[23];
+		return (width > 0 && height > 0);
+	}
+	
+	
+	
+	bool ReadJPGSize(const string &path, int &width, int &height)
+	{
+		File file(path);
+		if(!file)
+			return false;
+		
+		jpeg_decompress_struct cinfo;
+		struct jpeg_error_mgr jerr;
+		cinfo.err = jpeg_std_error(&jerr);
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wold-style-cast"
+		jpeg_create_decompress(&cinfo);
+#pragma GCC diagnostic pop
+		
+		jpeg_stdio_src(&cinfo, file);
+		jpeg_read_header(&cinfo, true);
+		width = cinfo.image_width;
+		height = cinfo.image_height;
+		jpeg_destroy_decompress(&cinfo);
+		
+		return (width > 0 && height > 0);
+	}
+	
+	
+	
 	void Premultiply(ImageBuffer &buffer, int frame, int additive)
 	{
 		for(int y = 0; y < buffer.Height(); ++y)
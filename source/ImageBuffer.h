@@ -50,10 +50,15 @@ public:
 	uint32_t *Begin(int y, int frame = 0);
 	
 	void ShrinkToHalfSize();
+	// Store a copy of this image, reduced to half size, in the given buffer.
+	void ShrinkToHalfSize(ImageBuffer &result) const;
 	
 	// Read a single frame. Return false if an error is encountered - either the
 	// image is the wrong size, or it is not a supported image format.
 	bool Read(const std::string &path, int frame = 0);
+	// Read only the dimensions of an image, without decoding it. Return false
+	// if it is not a supported image format.
+	static bool ReadSize(const std::string &path, int &width, int &height);
 	
 	
 private:
@@ -0,0 +1,278 @@
+/* ImageCache.cpp
+Copyright (c) 2021 by Michael Zahniser
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "ImageCache.h"
+
+#include "CacheFile.h"
+#include "Compression.h"
+#include "Files.h"
+#include "ImageBuffer.h"
+#include "MappedFile.h"
+#include "Mask.h"
+
+#include <cstdint>
+#include <cstring>
+
+using namespace std;
+
+namespace {
+	// Each cached sprite begins with this header. Change the version number
+	// whenever the format of the cache or the way images are decoded changes,
+	// so that old caches are ignored.
+	const string HEADER = "Endless Sky image cache 1\n";
+	// The same applies to the collision masks, which are cached separately
+	// and should change whenever the way masks are traced changes.
+	const string MASK_HEADER = "Endless Sky mask cache 1\n";
+	
+	string cacheDirectory;
+	
+	// Sprite names contain slashes, so each sprite's file is named by a hash
+	// of its name instead. The name is stored in the file, so that two sprites
+	// with the same hash just replace each other in the cache.
+	string Path(const string &name)
+	{
+		uint64_t hash = 14695981039346656037ull;
+		for(char c : name)
+			hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+		
+		string path = cacheDirectory;
+		for(int shift = 60; shift >= 0; shift -= 4)
+			path += "0123456789abcdef"[(hash >> shift) & 15];
+		return path;
+	}
+	
+	// Write the header for a cached sprite, followed by the path, modification
+	// time and size of each of the images it was made from.
+	void WriteHeader(string &out, const string &header, const string &name, const vector<string> *paths, int count)
+	{
+		out = header;
+		CacheFile::WriteString(out, name);
+		for(int i = 0; i < count; ++i)
+		{
+			CacheFile::WriteInt<uint32_t>(out, paths[i].size());
+			for(const string &path : paths[i])
+			{
+				CacheFile::WriteString(out, path);
+				CacheFile::WriteInt<int64_t>(out, Files::Timestamp(path));
+				CacheFile::WriteInt<uint64_t>(out, Files::Size(path));
+			}
+		}
+	}
+	
+	// Check that a cached sprite is still made of the same images, and that
+	// none of them have changed since it was cached.
+	bool ReadHeader(const char *&it, const char *end, const string &header, const string &name, const vector<string> *paths, int count)
+	{
+		if(static_cast<size_t>(end - it) < header.size() || header.compare(0, header.size(), it, header.size()))
+			return false;
+		it += header.size();
+		if(!CacheFile::MatchString(it, end, name))
+			return false;
+		
+		for(int i = 0; i < count; ++i)
+		{
+			uint32_t size = 0;
+			if(!CacheFile::ReadInt(it, end, size) || size != paths[i].size())
+				return false;
+			for(const string &path : paths[i])
+			{
+				int64_t timestamp = 0;
+				uint64_t bytes = 0;
+				if(!CacheFile::MatchString(it, end, path) || !CacheFile::ReadInt(it, end, timestamp)
+						|| !CacheFile::ReadInt(it, end, bytes))
+					return false;
+				if(timestamp != Files::Timestamp(path) || bytes != Files::Size(path))
+					return false;
+			}
+		}
+		return true;
+	}
+	
+	size_t Bytes(const ImageBuffer &buffer)
+	{
+		return 4 * static_cast<size_t>(buffer.Width()) * buffer.Height() * buffer.Frames();
+	}
+	
+	// Read the frames for one buffer, which may have been empty.
+	bool Read(const char *&it, const char *end, ImageBuffer &buffer)
+	{
+		int32_t width = 0;
+		int32_t height = 0;
+		int32_t frames = 0;
+		uint64_t size = 0;
+		if(!CacheFile::ReadInt(it, end, width) || !CacheFile::ReadInt(it, end, height)
+				|| !CacheFile::ReadInt(it, end, frames) || !CacheFile::ReadInt(it, end, size)
+				|| static_cast<uint64_t>(end - it) < size)
+			return false;
+		if(!width)
+			return true;
+		if(frames != buffer.Frames())
+			return false;
+		
+		buffer.Allocate(width, height);
+		if(!buffer.Pixels() || !Compression::Decompress(it, size, reinterpret_cast<char *>(buffer.Pixels()), Bytes(buffer)))
+			return false;
+		it += size;
+		return true;
+	}
+	
+	void Write(string &out, const ImageBuffer &buffer)
+	{
+		bool isEmpty = !buffer.Pixels();
+		CacheFile::WriteInt<int32_t>(out, isEmpty ? 0 : buffer.Width());
+		CacheFile::WriteInt<int32_t>(out, isEmpty ? 0 : buffer.Height());
+		CacheFile::WriteInt<int32_t>(out, isEmpty ? 0 : buffer.Frames());
+		
+		// The compressed size is not known until the frames are compressed.
+		size_t sizePos = out.size();
+		CacheFile::WriteInt<uint64_t>(out, 0);
+		if(isEmpty)
+			return;
+		
+		Compression::Compress(reinterpret_cast<const char *>(buffer.Pixels()), Bytes(buffer), out);
+		uint64_t size = out.size() - sizePos - sizeof(uint64_t);
+		memcpy(&out[sizePos], &size, sizeof(size));
+	}
+}
+
+
+
+// Store the cache in the given directory, creating it if necessary. Until
+// this is called, nothing is loaded from or saved to the cache.
+void ImageCache::Init(const string &directory)
+{
+	cacheDirectory = directory;
+	Files::CreateFolder(directory);
+}
+
+
+
+bool ImageCache::IsEnabled()
+{
+	return !cacheDirectory.empty();
+}
+
+
+
+// Load the 1x and 2x frames of the given sprite, and reduced copies of
+// them, if the cache holds them for exactly the given image paths. This may
+// be called from any thread. The buffers must already be cleared to the
+// number of frames that the sprite has.
+bool ImageCache::Load(const string &name, const vector<string> paths[2], ImageBuffer buffer[2], ImageBuffer reduced[2])
+{
+	if(!IsEnabled())
+		return false;
+	
+	MappedFile file(Path(name));
+	const char *it = file.Data();
+	const char *end = it + file.Size();
+	if(!ReadHeader(it, end, HEADER, name, paths, 2))
+		return false;
+	
+	if(Read(it, end, buffer[0]) && Read(it, end, buffer[1]) && Read(it, end, reduced[0])
+			&& Read(it, end, reduced[1]) && it == end)
+		return true;
+	
+	// Don't leave any partly loaded frames behind.
+	for(int i = 0; i < 2; ++i)
+	{
+		buffer[i].Clear(buffer[i].Frames());
+		reduced[i].Clear(reduced[i].Frames());
+	}
+	return false;
+}
+
+
+
+// Save the frames of the given sprite, replacing any that were cached for it
+// before. This may be called from any thread.
+void ImageCache::Save(const string &name, const vector<string> paths[2], const ImageBuffer buffer[2], const ImageBuffer reduced[2])
+{
+	if(!IsEnabled())
+		return;
+	
+	string out;
+	WriteHeader(out, HEADER, name, paths, 2);
+	Write(out, buffer[0]);
+	Write(out, buffer[1]);
+	Write(out, reduced[0]);
+	Write(out, reduced[1]);
+	CacheFile::Replace(Path(name), out);
+}
+
+
+
+// Load the collision masks of the given sprite, if the cache holds them for
+// exactly the given 1x image paths. Because this does not need the images
+// themselves, the masks can be loaded without decoding any images.
+bool ImageCache::LoadMasks(const string &name, const vector<string> &paths, vector<Mask> &masks)
+{
+	if(!IsEnabled())
+		return false;
+	
+	MappedFile file(Path(name) + ".mask");
+	const char *it = file.Data();
+	const char *end = it + file.Size();
+	uint32_t count = 0;
+	if(!ReadHeader(it, end, MASK_HEADER, name, &paths, 1) || !CacheFile::ReadInt(it, end, count)
+			|| count != masks.size())
+		return false;
+	
+	// Each mask is stored as the number of points in its outline, followed by
+	// the coordinates of each point.
+	vector<vector<Point>> outlines(count);
+	for(vector<Point> &outline : outlines)
+	{
+		uint32_t points = 0;
+		if(!CacheFile::ReadInt(it, end, points) || static_cast<size_t>(end - it) / (2 * sizeof(double)) < points)
+			return false;
+		outline.reserve(points);
+		for(uint32_t i = 0; i < points; ++i)
+		{
+			double x = 0.;
+			double y = 0.;
+			CacheFile::ReadInt(it, end, x);
+			CacheFile::ReadInt(it, end, y);
+			outline.emplace_back(x, y);
+		}
+	}
+	if(it != end)
+		return false;
+	
+	for(size_t i = 0; i < masks.size(); ++i)
+		masks[i].Create(move(outlines[i]));
+	return true;
+}
+
+
+
+// Save the collision masks of the given sprite, replacing any that were
+// cached for it before. This may be called from any thread.
+void ImageCache::SaveMasks(const string &name, const vector<string> &paths, const vector<Mask> &masks)
+{
+	if(!IsEnabled())
+		return;
+	
+	string out;
+	WriteHeader(out, MASK_HEADER, name, &paths, 1);
+	CacheFile::WriteInt<uint32_t>(out, masks.size());
+	for(const Mask &mask : masks)
+	{
+		CacheFile::WriteInt<uint32_t>(out, mask.Points().size());
+		for(const Point &point : mask.Points())
+		{
+			CacheFile::WriteInt<double>(out, point.X());
+			CacheFile::WriteInt<double>(out, point.Y());
+		}
+	}
+	CacheFile::Replace(Path(name) + ".mask", out);
+}
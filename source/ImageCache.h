@@ -0,0 +1,61 @@
+/* ImageCache.h
+Copyright (c) 2021 by Michael Zahniser
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#ifndef IMAGE_CACHE_H_
+#define IMAGE_CACHE_H_
+
+#include <string>
+#include <vector>
+
+class ImageBuffer;
+class Mask;
+
+
+
+// A cache of decoded sprite frames, so that loading a sprite whose images have
+// not changed does not require decoding any PNG or JPEG files. Each sprite is
+// stored in its own compressed file, along with the modification time and size
+// of every image it was made from, and it is only used if those still match.
+// Along with the 1x and 2x frames, the cache holds half size copies of any
+// frames that are large enough to be reduced, so those need not be recomputed.
+// Collision masks are cached in a separate file next to each sprite's frames.
+class ImageCache {
+public:
+	// Store the cache in the given directory, creating it if necessary. Until
+	// this is called, nothing is loaded from or saved to the cache.
+	static void Init(const std::string &directory);
+	static bool IsEnabled();
+	
+	// Load the 1x and 2x frames of the given sprite, and reduced copies of
+	// them, if the cache holds them for exactly the given image paths. This may
+	// be called from any thread. The buffers must already be cleared to the
+	// number of frames that the sprite has.
+	static bool Load(const std::string &name, const std::vector<std::string> paths[2],
+		ImageBuffer buffer[2], ImageBuffer reduced[2]);
+	// Save the frames of the given sprite, replacing any that were cached for it
+	// before. This may be called from any thread.
+	static void Save(const std::string &name, const std::vector<std::string> paths[2],
+		const ImageBuffer buffer[2], const ImageBuffer reduced[2]);
+	
+	// Load the collision masks of the given sprite, if the cache holds them for
+	// exactly the given 1x image paths. Because this does not need the images
+	// themselves, the masks can be loaded without decoding any images. The
+	// vector must already be sized to the number of frames.
+	static bool LoadMasks(const std::string &name, const std::vector<std::string> &paths, std::vector<Mask> &masks);
+	// Save the collision masks of the given sprite, replacing any that were
+	// cached for it before. This may be called from any thread.
+	static void SaveMasks(const std::string &name, const std::vector<std::string> &paths, const std::vector<Mask> &masks);
+};
+
+
+
+#endif
@@ -13,9 +13,12 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "ImageSet.h"
 
 #include "Files.h"
+#include "ImageCache.h"
 #include "Mask.h"
 #include "Sprite.h"
 
+#include <algorithm>
+
 using namespace std;
 
 namespace {
@@ -109,10 +112,9 @@ bool ImageSet::Is2x(const string &path)
 // should be deferred until needed.
 bool ImageSet::IsDeferred(const string &path)
 {
-	if(path.length() >= 5 && !path.compare(0, 5, "land/"))
-		return true;
-	
-	return false;
+	// Collision masks may be needed even if a sprite is never drawn, so any
+	// sprite that has them must be loaded right away.
+	return !IsMasked(path);
 }
 
 
@@ -134,7 +136,7 @@ bool ImageSet::IsMasked(const string &path)
 // Constructor, optionally specifying the name (for image sets like the
 // plugin icons, whose name can't be determined from the path names).
 ImageSet::ImageSet(const string &name)
-	: name(name)
+	: name(name), isComplete(true)
 {
 }
 
@@ -187,42 +189,144 @@ void ImageSet::Check() const
 
 
 
-// Load all the frames. This should be called in one of the image-loading
-// worker threads. This also generates collision masks if needed.
-void ImageSet::Load()
+// Mark this as a sprite whose frames are not loaded until it is drawn. The
+// first time it is loaded, only the dimensions of its images are read.
+void ImageSet::Defer()
 {
-	// Determine how many frames there will be, total. The image buffers will
-	// not actually be allocated until the first image is loaded (at which point
-	// the sprite's dimensions will be known).
+	isDeferred = true;
+}
+
+
+
+// Begin loading the frames. This should be called in one of the image-
+// loading worker threads. Anything that does not require decoding the
+// individual images, like loading cached frames or reading the dimensions of
+// a deferred sprite, is done here. Returns the number of frames that must
+// then be read with LoadFrame(), which may be zero.
+size_t ImageSet::Prepare()
+{
+	// Every frame must have the same dimensions, so reading them from any
+	// one of the 1x images is enough.
+	if(isDeferred && !width)
+	{
+		for(const string &path : paths[0])
+			if(!path.empty() && ImageBuffer::ReadSize(path, width, height))
+				return 0;
+		
+		// If none of the images' dimensions can be read, load them in full
+		// instead, so that whatever is wrong with them is reported.
+		isDeferred = false;
+	}
+	
+	// Determine how many frames there will be, total.
 	size_t frames = paths[0].size();
-	buffer[0].Clear(frames);
-	buffer[1].Clear(frames);
+	for(int i = 0; i < 2; ++i)
+	{
+		buffer[i].Clear(frames);
+		reduced[i].Clear(frames);
+	}
+	isComplete = true;
 	
-	// Check whether we need to generate collision masks.
-	bool makeMasks = IsMasked(name);
+	// Check whether we need to generate collision masks. If the masks were
+	// cached, there is no need to trace them again.
+	makeMasks = IsMasked(name);
 	if(makeMasks)
+	{
 		masks.resize(frames);
+		makeMasks = !ImageCache::LoadMasks(name, paths[0], masks);
+	}
 	
-	// Load the 1x sprites first, then the 2x sprites, because they are likely
-	// to be in separate locations on the disk. Create masks if needed.
-	for(size_t i = 0; i < frames; ++i)
-		if(buffer[0].Read(paths[0][i], i) && makeMasks)
+	// If none of the images have changed since they were cached, there is no
+	// need to decode them again.
+	if(ImageCache::Load(name, paths, buffer, reduced))
+	{
+		for(size_t i = 0; i < frames && makeMasks; ++i)
 			masks[i].Create(buffer[0], i);
-	// Now, load the 2x sprites, if they exist. Because the number of 1x frames
-	// is definitive, don't load any frames beyond the size of the 1x list.
-	for(size_t i = 0; i < frames && i < paths[1].size(); ++i)
-		buffer[1].Read(paths[1][i], i);
+		if(makeMasks)
+			ImageCache::SaveMasks(name, paths[0], masks);
+		makeMasks = false;
+		return 0;
+	}
+	
+	// The frames may be read in parallel, so the buffers must be allocated
+	// before any of them are, based on the dimensions of the first frame that
+	// can be read. Any frames with different dimensions will fail to load.
+	for(int i = 0; i < 2; ++i)
+		for(size_t j = 0; j < frames && j < paths[i].size(); ++j)
+		{
+			int frameWidth = 0;
+			int frameHeight = 0;
+			if(!paths[i][j].empty() && ImageBuffer::ReadSize(paths[i][j], frameWidth, frameHeight))
+			{
+				buffer[i].Allocate(frameWidth, frameHeight);
+				break;
+			}
+		}
+	
+	// Because the number of 1x frames is definitive, don't load any 2x frames
+	// beyond the size of the 1x list.
+	return frames + min(frames, paths[1].size());
 }
 
 
 
-// Create the sprite and upload the image data to the GPU. After this is
-// called, the internal image buffers and mask vector will be cleared, but
-// the paths are saved in case the sprite needs to be loaded again.
-void ImageSet::Upload(Sprite *sprite)
+// Read one frame, numbering the 1x frames first and then the 2x frames. This
+// may be called from several threads at once, each for a different frame.
+// This also generates the frame's collision mask, if needed.
+void ImageSet::LoadFrame(size_t index)
 {
+	size_t frames = paths[0].size();
+	bool is2x = (index >= frames);
+	size_t frame = is2x ? index - frames : index;
+	
+	// If the buffer could not be allocated, none of its frames can be read.
+	bool isRead = buffer[is2x].Pixels() && buffer[is2x].Read(paths[is2x][frame], frame);
+	if(isRead && makeMasks && !is2x)
+		masks[frame].Create(buffer[0], frame);
+	if(!isRead)
+		isComplete = false;
+}
+
+
+
+// Finish loading, once all the frames have been read.
+void ImageSet::Finish()
+{
+	// Only cache sprites that have no missing or broken frames, so that any
+	// errors in them will still be reported the next time they are loaded.
+	if(ImageCache::IsEnabled() && isComplete)
+	{
+		for(int i = 0; i < 2; ++i)
+			if(buffer[i].Pixels() && Sprite::IsLarge(buffer[i]))
+				buffer[i].ShrinkToHalfSize(reduced[i]);
+		ImageCache::Save(name, paths, buffer, reduced);
+		if(makeMasks)
+			ImageCache::SaveMasks(name, paths[0], masks);
+	}
+}
+
+
+
+// Create the sprite and upload the image data to the GPU, using up to the
+// given budget of bytes. Returns false if this must be called again to
+// upload the rest of it. Once it is done, the internal image buffers and
+// mask vector will be cleared, but the paths are saved in case the sprite
+// needs to be loaded again.
+bool ImageSet::Upload(Sprite *sprite, size_t &budget)
+{
+	// If only the dimensions of a deferred sprite have been read, there are
+	// no frames to upload yet.
+	if(isDeferred && !buffer[0].Pixels())
+	{
+		if(width)
+			sprite->Defer(width, height, paths[0].size());
+		return true;
+	}
+	
 	// Load the frames. This will clear the buffers and the mask vector.
-	sprite->AddFrames(buffer[0], false);
-	sprite->AddFrames(buffer[1], true);
+	if(!sprite->AddFrames(buffer[0], false, reduced[0], budget)
+			|| !sprite->AddFrames(buffer[1], true, reduced[1], budget))
+		return false;
 	sprite->AddMasks(masks);
+	return true;
 }
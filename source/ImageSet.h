@@ -15,6 +15,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 
 #include "ImageBuffer.h"
 
+#include <atomic>
 #include <string>
 #include <vector>
 
@@ -58,13 +59,27 @@ public:
 	// Check this image set to determine whether any frames are missing. Report
 	// an error for each missing frame. (It will be left uninitialized.)
 	void Check() const;
-	// Load all the frames. This should be called in one of the image-loading
-	// worker threads. This also generates collision masks if needed.
-	void Load();
-	// Create the sprite and upload the image data to the GPU. After this is
-	// called, the internal image buffers and mask vector will be cleared, but
-	// the paths are saved in case the sprite needs to be loaded again.
-	void Upload(Sprite *sprite);
+	// Mark this as a sprite whose frames are not loaded until it is drawn. The
+	// first time it is loaded, only the dimensions of its images are read.
+	void Defer();
+	// Begin loading the frames. This should be called in one of the image-
+	// loading worker threads. Anything that does not require decoding the
+	// individual images, like loading cached frames or reading the dimensions of
+	// a deferred sprite, is done here. Returns the number of frames that must
+	// then be read with LoadFrame(), which may be zero.
+	size_t Prepare();
+	// Read one frame, numbering the 1x frames first and then the 2x frames. This
+	// may be called from several threads at once, each for a different frame.
+	// This also generates the frame's collision mask, if needed.
+	void LoadFrame(size_t index);
+	// Finish loading, once all the frames have been read.
+	void Finish();
+	// Create the sprite and upload the image data to the GPU, using up to the
+	// given budget of bytes. Returns false if this must be called again to
+	// upload the rest of it. Once it is done, the internal image buffers and
+	// mask vector will be cleared, but the paths are saved in case the sprite
+	// needs to be loaded again.
+	bool Upload(Sprite *sprite, size_t &budget);
 	
 	
 private:
@@ -72,9 +87,18 @@ private:
 	std::string name;
 	// Paths to all the images that must be loaded:
 	std::vector<std::string> paths[2];
+	// Whether this sprite is deferred, and if so, its dimensions once known:
+	bool isDeferred = false;
+	int width = 0;
+	int height = 0;
 	// Data loaded from the images:
 	ImageBuffer buffer[2];
+	// Half size copies of any large frames, if they were cached:
+	ImageBuffer reduced[2];
 	std::vector<Mask> masks;
+	// The state of the frames that are currently being loaded:
+	bool makeMasks = false;
+	std::atomic<bool> isComplete;
 };
 
 
@@ -45,7 +45,9 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "gl_header.h"
 
 #include <algorithm>
+#include <iterator>
 #include <stdexcept>
+#include <vector>
 
 using namespace std;
 using namespace Gettext;
@@ -95,6 +97,8 @@ namespace {
 	// Only show tooltips if the mouse has hovered in one place for this amount
 	// of time.
 	const int HOVER_TIME = 60;
+	// How many saved games above and below the selected one to read in advance.
+	const int PREVIEW_AHEAD = 2;
 }
 
 
@@ -115,6 +119,30 @@ LoadPanel::LoadPanel(PlayerInfo &player, UI &gamePanels)
 
 
 
+void LoadPanel::Step()
+{
+	// Add any pilots whose saved games have been listed since the last step.
+	if(saves.TakePilots(files))
+	{
+		if(selectedPilot.empty())
+			selectedPilot = files.begin()->first;
+		if(selectedFile.empty())
+		{
+			auto it = files.find(selectedPilot);
+			if(it != files.end())
+				selectedFile = it->second.front().first;
+		}
+		// Any newly listed pilots may be next to the selected one.
+		Preview();
+	}
+	// If the selected saved game had not been read yet when it was selected,
+	// show it as soon as it has been.
+	if(!selectedFile.empty() && loadedInfo.Path() != Files::Saves() + selectedFile)
+		saves.Get(selectedFile, loadedInfo);
+}
+
+
+
 void LoadPanel::Draw()
 {
 	glClear(GL_COLOR_BUFFER_BIT);
@@ -318,7 +346,7 @@ bool LoadPanel::KeyDown(SDL_Keycode key, Uint16 mod, const Command &command, boo
 			}
 			selectedFile = it->first;
 		}
-		loadedInfo.Load(Files::Saves() + selectedFile);
+		Preview();
 	}
 	else if(key == SDLK_LEFT)
 		sideHasFocus = true;
@@ -372,8 +400,7 @@ bool LoadPanel::Click(int x, int y, int clicks)
 	else
 		return false;
 	
-	if(!selectedFile.empty())
-		loadedInfo.Load(Files::Saves() + selectedFile);
+	Preview();
 	
 	return true;
 }
@@ -421,43 +448,44 @@ bool LoadPanel::Scroll(double dx, double dy)
 
 void LoadPanel::UpdateLists()
 {
+	// The saved games are listed in the background, and each pilot is added to
+	// the list once all of their saved games have been found.
 	files.clear();
+	saves.List();
+}
+
+
+
+// Show the selected saved game, and read the ones next to it in advance.
+void LoadPanel::Preview()
+{
+	if(selectedFile.empty())
+		return;
 	
-	vector<string> fileList = Files::List(Files::Saves());
-	for(const string &path : fileList)
-	{
-		string fileName = Files::Name(path);
-		// The file name is either "Pilot Name.txt" or "Pilot Name~SnapshotTitle.txt".
-		size_t pos = fileName.find('~');
-		if(pos == string::npos)
-			pos = fileName.size() - 4;
-		
-		string pilotName = fileName.substr(0, pos);
-		files[pilotName].emplace_back(fileName, Files::Timestamp(path));
-	}
-	
-	for(auto &it : files)
-		sort(it.second.begin(), it.second.end(),
-			[](const pair<string, time_t> &a, const pair<string, time_t> &b) -> bool
-			{
-				return a.second > b.second;
-			}
-		);
-	
-	if(!files.empty())
+	// The saved games next to the selected one, and the most recent saves of
+	// the pilots next to this one, are likely to be selected next.
+	vector<string> fileNames(1, selectedFile);
+	auto pit = files.find(selectedPilot);
+	if(pit != files.end())
 	{
-		if(selectedPilot.empty())
-			selectedPilot = files.begin()->first;
-		if(selectedFile.empty())
+		const auto &list = pit->second;
+		int index = 0;
+		while(index < static_cast<int>(list.size()) && list[index].first != selectedFile)
+			++index;
+		for(int i = 1; i <= PREVIEW_AHEAD; ++i)
 		{
-			auto it = files.find(selectedPilot);
-			if(it != files.end())
-			{
-				selectedFile = it->second.front().first;
-				loadedInfo.Load(Files::Saves() + selectedFile);
-			}
+			if(index + i < static_cast<int>(list.size()))
+				fileNames.push_back(list[index + i].first);
+			if(index - i >= 0)
+				fileNames.push_back(list[index - i].first);
 		}
+		if(next(pit) != files.end())
+			fileNames.push_back(next(pit)->second.front().first);
+		if(pit != files.begin())
+			fileNames.push_back(prev(pit)->second.front().first);
 	}
+	saves.Preview(fileNames);
+	saves.Get(selectedFile, loadedInfo);
 }
 
 
@@ -498,7 +526,7 @@ void LoadPanel::WriteSnapshot(const string &sourceFile, const string &snapshotNa
 	{
 		UpdateLists();
 		selectedFile = Files::Name(snapshotName);
-		loadedInfo.Load(Files::Saves() + selectedFile);
+		Preview();
 	}
 	else
 		GetUI()->Push(new Dialog(Format::StringF(T("Error: unable to create the file \"%1%\"."),
@@ -515,7 +543,9 @@ void LoadPanel::LoadCallback()
 	gamePanels.Reset();
 	gamePanels.CanSave(true);
 	
-	player.Load(loadedInfo.Path());
+	// The selected saved game may not have been read yet, but it is the one
+	// that should be loaded.
+	player.Load(Files::Saves() + selectedFile);
 	
 	GetUI()->Pop(this);
 	GetUI()->Pop(GetUI()->Root().get());
@@ -558,22 +588,14 @@ void LoadPanel::DeletePilot()
 void LoadPanel::DeleteSave()
 {
 	loadedInfo.Clear();
-	string pilot = selectedPilot;
 	string path = Files::Saves() + selectedFile;
 	Files::Delete(path);
 	if(Files::Exists(path))
 		GetUI()->Push(new Dialog(T("Deleting snapshot file failed.")));
 	
-	sideHasFocus = true;
-	selectedPilot.clear();
+	// Once this pilot's saved games have been listed again, their most recent
+	// one will be selected.
+	sideHasFocus = false;
+	selectedFile.clear();
 	UpdateLists();
-	
-	auto it = files.find(pilot);
-	if(it != files.end() && !it->second.empty())
-	{
-		selectedFile = it->second.front().first;
-		selectedPilot = pilot;
-		loadedInfo.Load(Files::Saves() + selectedFile);
-		sideHasFocus = false;
-	}
 }
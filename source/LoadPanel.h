@@ -17,12 +17,9 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 
 #include "Point.h"
 #include "SavedGame.h"
+#include "SavedGameQueue.h"
 
-#include <ctime>
-#include <map>
 #include <string>
-#include <utility>
-#include <vector>
 
 class PlayerInfo;
 class UI;
@@ -36,6 +33,7 @@ class LoadPanel : public Panel {
 public:
 	LoadPanel(PlayerInfo &player, UI &gamePanels);
 	
+	virtual void Step() override;
 	virtual void Draw() override;
 	
 	
@@ -50,6 +48,8 @@ protected:
 	
 private:
 	void UpdateLists();
+	// Show the selected saved game, and read the ones next to it in advance.
+	void Preview();
 	
 	// Snapshot name callback.
 	void SnapshotCallback(const std::string &name);
@@ -66,7 +66,9 @@ private:
 	SavedGame loadedInfo;
 	UI &gamePanels;
 	
-	std::map<std::string, std::vector<std::pair<std::string, std::time_t>>> files;
+	SavedGameQueue::FileList files;
+	// The saved games are listed and read in the background.
+	SavedGameQueue saves;
 	std::string selectedPilot;
 	std::string selectedFile;
 	// If the player enters a filename that exists, prompt before overwriting it.
@@ -19,6 +19,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "Government.h"
 #include "Planet.h"
 #include "Random.h"
+#include "Set.h"
 #include "Ship.h"
 #include "StellarObject.h"
 #include "System.h"
@@ -125,6 +126,16 @@ namespace {
 				return f.IsValid();
 			});
 	}
+	// Get the system that a planet or system is in.
+	const System *SystemOf(const Planet *planet)
+	{
+		return planet->GetSystem();
+	}
+	const System *SystemOf(const System *system)
+	{
+		return system;
+	}
+	
 	bool CheckValidity(const list<set<const Outfit *>> &l)
 	{
 		if(l.empty())
@@ -151,6 +162,10 @@ LocationFilter::LocationFilter(const DataNode &node)
 
 void LocationFilter::Load(const DataNode &node)
 {
+	// Anything that was found to match before may not match anymore.
+	planetCandidates = Candidates<Planet>();
+	systemCandidates = Candidates<System>();
+	
 	for(const DataNode &child : node)
 	{
 		// Handle filters that must not match, or must apply to a
@@ -324,8 +339,8 @@ bool LocationFilter::Matches(const Planet *planet, const System *origin) const
 	
 	if(!planets.empty() && !planets.count(planet))
 		return false;
-	for(const set<string> &attr : attributes)
-		if(!SetsIntersect(attr, planet->Attributes()))
+	for(const AttributeBits &attr : attributeBits)
+		if(!attr.Intersects(planet->GetAttributeBits()))
 			return false;
 	
 	for(const LocationFilter &filter : notFilters)
@@ -410,6 +425,30 @@ bool LocationFilter::Matches(const Ship &ship) const
 
 
 
+// Get the planets and systems that a planet must be one of or be in, and
+// the sets of attributes that it must have one of each of, to match this
+// filter. Any of these that are empty do not restrict which planets match.
+const set<const Planet *> &LocationFilter::Planets() const
+{
+	return planets;
+}
+
+
+
+const set<const System *> &LocationFilter::Systems() const
+{
+	return systems;
+}
+
+
+
+const list<set<string>> &LocationFilter::Attributes() const
+{
+	return attributes;
+}
+
+
+
 // Convert a "distance" filter into a "near" filter.
 LocationFilter LocationFilter::SetOrigin(const System *origin) const
 {
@@ -431,6 +470,8 @@ LocationFilter LocationFilter::SetOrigin(const System *origin) const
 	// Revert "distance" parameters to their default.
 	result.originMinDistance = 0;
 	result.originMaxDistance = -1;
+	result.planetCandidates = Candidates<Planet>();
+	result.systemCandidates = Candidates<System>();
 	
 	return result;
 }
@@ -440,16 +481,7 @@ LocationFilter LocationFilter::SetOrigin(const System *origin) const
 // Pick a random system that matches this filter, based on the given origin.
 const System *LocationFilter::PickSystem(const System *origin) const
 {
-	// Find a planet that satisfies the filter.
-	vector<const System *> options;
-	for(const auto &it : GameData::Systems())
-	{
-		// Skip entries with incomplete data.
-		if(!it.second.IsValid())
-			continue;
-		if(Matches(&it.second, origin))
-			options.push_back(&it.second);
-	}
+	const vector<const System *> &options = FindCandidates(systemCandidates, GameData::Systems(), origin);
 	return options.empty() ? nullptr : options[Random::Int(options.size())];
 }
 
@@ -459,19 +491,16 @@ const System *LocationFilter::PickSystem(const System *origin) const
 const Planet *LocationFilter::PickPlanet(const System *origin, bool hasClearance, bool requireSpaceport) const
 {
 	// Find a planet that satisfies the filter.
+	// Whether the player can land on a planet changes all the time, so that
+	// is not remembered along with which planets match.
 	vector<const Planet *> options;
-	for(const auto &it : GameData::Planets())
+	for(const Planet *planet : FindCandidates(planetCandidates, GameData::Planets(), origin))
 	{
-		const Planet &planet = it.second;
-		// Skip entries with incomplete data.
-		if(!planet.IsValid())
-			continue;
 		// Skip planets that do not offer special jobs or missions, unless they were explicitly listed as options.
-		if(planet.IsWormhole() || (requireSpaceport && !planet.HasSpaceport()) || (!hasClearance && !planet.CanLand()))
-			if(planets.empty() || !planets.count(&planet))
+		if(planet->IsWormhole() || (requireSpaceport && !planet->HasSpaceport()) || (!hasClearance && !planet->CanLand()))
+			if(planets.empty() || !planets.count(planet))
 				continue;
-		if(Matches(&planet, origin))
-			options.push_back(&planet);
+		options.push_back(planet);
 	}
 	return options.empty() ? nullptr : options[Random::Int(options.size())];
 }
@@ -521,6 +550,8 @@ void LocationFilter::LoadChild(const DataNode &child)
 		// Don't allow empty attribute sets; that's probably a typo.
 		if(attributes.back().empty())
 			attributes.pop_back();
+		else
+			attributeBits.emplace_back(attributes.back());
 	}
 	else if(key == "near" && child.Size() >= 1 + valueIndex)
 	{
@@ -588,12 +619,12 @@ bool LocationFilter::Matches(const System *system, const System *origin, bool di
 		// required attributes from each set.
 		if(!attributes.empty())
 		{
-			for(const set<string> &attr : attributes)
+			for(const AttributeBits &attr : attributeBits)
 			{
-				bool matches = SetsIntersect(attr, system->Attributes());
+				bool matches = attr.Intersects(system->GetAttributeBits());
 				for(const StellarObject &object : system->Objects())
-					if(object.GetPlanet())
-						matches |= SetsIntersect(attr, object.GetPlanet()->Attributes());
+					if(!matches && object.GetPlanet())
+						matches = attr.Intersects(object.GetPlanet()->GetAttributeBits());
 				
 				if(!matches)
 					return false;
@@ -617,3 +648,62 @@ bool LocationFilter::Matches(const System *system, const System *origin, bool di
 	
 	return true;
 }
+
+
+
+// Check if any filter nested in this one has a "distance" filter, which
+// means that whether it matches depends on the origin in other ways than
+// through this filter's own distance limits.
+bool LocationFilter::HasNestedOrigin() const
+{
+	for(const list<LocationFilter> *filters : {&notFilters, &neighborFilters})
+		for(const LocationFilter &filter : *filters)
+			if(filter.originMaxDistance >= 0 || filter.HasNestedOrigin())
+				return true;
+	return false;
+}
+
+
+
+// Get all the planets or systems that match this filter from the given
+// origin, in the same order as in GameData.
+template <class Type>
+const vector<const Type *> &LocationFilter::FindCandidates(Candidates<Type> &cache, const Set<Type> &all, const System *origin) const
+{
+	// Without an origin, this filter's own distance limits are not checked.
+	// If no nested filter has distance limits either, whatever matches from
+	// an origin is a subset of what matches without one.
+	if(cache.revision != GameData::Revision())
+	{
+		cache = Candidates<Type>();
+		cache.revision = GameData::Revision();
+		cache.hasNestedOrigin = HasNestedOrigin();
+		for(const auto &it : all)
+		{
+			// Skip entries with incomplete data.
+			if(!it.second.IsValid())
+				continue;
+			if(cache.hasNestedOrigin || Matches(&it.second, nullptr))
+				cache.all.push_back(&it.second);
+		}
+	}
+	if(!origin || (originMaxDistance < 0 && !cache.hasNestedOrigin))
+		return cache.all;
+	
+	if(cache.origin != origin)
+	{
+		cache.origin = origin;
+		cache.fromOrigin.clear();
+		for(const Type *candidate : cache.all)
+		{
+			if(cache.hasNestedOrigin)
+			{
+				if(Matches(candidate, origin))
+					cache.fromOrigin.push_back(candidate);
+			}
+			else if(Distance(origin, SystemOf(candidate), originMaxDistance) >= originMinDistance)
+				cache.fromOrigin.push_back(candidate);
+		}
+	}
+	return cache.fromOrigin;
+}
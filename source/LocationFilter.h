@@ -13,9 +13,12 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #ifndef LOCATION_FILTER_H_
 #define LOCATION_FILTER_H_
 
+#include "AttributeBits.h"
+
 #include <list>
 #include <set>
 #include <string>
+#include <vector>
 
 class DataNode;
 class DataWriter;
@@ -24,13 +27,18 @@ class Outfit;
 class Planet;
 class Ship;
 class System;
+template <class Type>
+class Set;
 
 
 
 // This class represents a set of constraints on a randomly chosen ship, planet,
 // or system. For example, it can require that the planet used for a mission
 // have a certain attribute or be owned by a certain government, or be a
-// certain distance away from the current system.
+// certain distance away from the current system. The planets and systems that
+// match a filter are remembered until the universe changes, and so are the
+// ones that match from the last origin that was used, so picking from them
+// again does not require checking every planet or system.
 class LocationFilter {
 public:
 	LocationFilter() = default;
@@ -54,6 +62,13 @@ public:
 	// of ship, outfits installed/carried, and their total attributes.
 	bool Matches(const Ship &ship) const;
 	
+	// Get the planets and systems that a planet must be one of or be in, and
+	// the sets of attributes that it must have one of each of, to match this
+	// filter. Any of these that are empty do not restrict which planets match.
+	const std::set<const Planet *> &Planets() const;
+	const std::set<const System *> &Systems() const;
+	const std::list<std::set<std::string>> &Attributes() const;
+	
 	// Return a new LocationFilter with any "distance" conditions converted
 	// into "near" references, relative to the given system.
 	LocationFilter SetOrigin(const System *origin) const;
@@ -63,6 +78,24 @@ public:
 	const Planet *PickPlanet(const System *origin, bool hasClearance = false, bool requireSpaceport = true) const;
 	
 	
+private:
+	// The planets or systems that match this filter, which are kept until
+	// the universe changes.
+	template <class Type>
+	class Candidates {
+	public:
+		// The value of GameData::Revision() when these were found.
+		int revision = -1;
+		// Whether any nested filter depends on the origin.
+		bool hasNestedOrigin = false;
+		// Everything that matches from some origin.
+		std::vector<const Type *> all;
+		// Everything that matches from the last origin that was asked for.
+		const System *origin = nullptr;
+		std::vector<const Type *> fromOrigin;
+	};
+	
+	
 private:
 	// Load one particular line of conditions.
 	void LoadChild(const DataNode &child);
@@ -70,6 +103,14 @@ private:
 	// only if the filter wasn't looking for planet characteristics or if the
 	// didPlanet argument is set (meaning we already checked those).
 	bool Matches(const System *system, const System *origin, bool didPlanet) const;
+	// Check if any filter nested in this one has a "distance" filter, which
+	// means that whether it matches depends on the origin in other ways than
+	// through this filter's own distance limits.
+	bool HasNestedOrigin() const;
+	// Get all the planets or systems that match this filter from the given
+	// origin, in the same order as in GameData.
+	template <class Type>
+	const std::vector<const Type *> &FindCandidates(Candidates<Type> &cache, const Set<Type> &all, const System *origin) const;
 	
 	
 private:
@@ -77,6 +118,8 @@ private:
 	std::set<const Planet *> planets;
 	// It must have at least one attribute from each set in this list:
 	std::list<std::set<std::string>> attributes;
+	// The same sets, as bitsets:
+	std::list<AttributeBits> attributeBits;
 	
 	// The system must satisfy these conditions:
 	std::set<const System *> systems;
@@ -99,6 +142,10 @@ private:
 	std::list<LocationFilter> notFilters;
 	// These filters store all the things the planet or system must border.
 	std::list<LocationFilter> neighborFilters;
+	
+	// The planets and systems that match this filter.
+	mutable Candidates<Planet> planetCandidates;
+	mutable Candidates<System> systemCandidates;
 };
 
 
@@ -40,12 +40,15 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "PointerShader.h"
 #include "Politics.h"
 #include "Preferences.h"
+#include "PrimitiveDrawList.h"
+#include "Rectangle.h"
 #include "RingShader.h"
 #include "Screen.h"
 #include "Ship.h"
 #include "SpriteShader.h"
 #include "StellarObject.h"
 #include "System.h"
+#include "SystemGrid.h"
 #include "Trade.h"
 #include "UI.h"
 
@@ -186,6 +189,10 @@ void MapPanel::Draw()
 	RingShader::Draw(Zoom() * (selectedSystem->Position() + center),
 		11.f, 9.f, brightColor);
 	
+	// The systems are colored according to the current commodity.
+	if(commodity != cachedCommodity)
+		UpdateCache();
+	
 	// Advance a "blink" timer.
 	++step;
 	// Update the tooltip timer [0-60].
@@ -403,15 +410,22 @@ bool MapPanel::KeyDown(SDL_Keycode key, Uint16 mod, const Command &command, bool
 
 bool MapPanel::Click(int x, int y, int clicks)
 {
-	// Figure out if a system was clicked on.
+	// Figure out if a system was clicked on. If more than one is in range,
+	// pick the closest one.
 	Point click = Point(x, y) / Zoom() - center;
-	for(const auto &it : GameData::Systems())
-		if(it.second.IsValid() && click.Distance(it.second.Position()) < 10.
-				&& (player.HasSeen(it.second) || &it.second == specialSystem))
+	const System *clicked = nullptr;
+	double closest = 10.;
+	for(const System *system : GameData::SystemLocations().Within(click, closest))
+	{
+		double distance = click.Distance(system->Position());
+		if(system->IsValid() && distance < closest && (player.HasSeen(*system) || system == specialSystem))
 		{
-			Select(&it.second);
-			break;
+			clicked = system;
+			closest = distance;
 		}
+	}
+	if(clicked)
+		Select(clicked);
 	
 	return true;
 }
@@ -440,10 +454,9 @@ bool MapPanel::Hover(int x, int y)
 	}
 	
 	// Check if the new position supports a tooltip.
-	for(const auto &squad : escortSystems)
+	for(const System *system : GameData::SystemLocations().Within(pos, maxDistance))
 	{
-		const System *system = squad.first;
-		if(pos.Distance(system->Position()) < maxDistance
+		if(escortSystems.count(system) && pos.Distance(system->Position()) < maxDistance
 				&& (player.HasSeen(*system) || system == specialSystem))
 		{
 			// Start tracking this system.
@@ -720,11 +733,14 @@ void MapPanel::UpdateCache()
 	// Remember which commodity the cached systems are colored by.
 	cachedCommodity = commodity;
 	nodes.clear();
+	nameWidth = 0.;
 	
 	// Draw the circles for the systems, colored based on the selected criterion,
 	// which may be government, services, or commodity prices.
+	PrimitiveDrawList shapes;
 	const Color &closeNameColor = *GameData::Colors().Get("map name");
 	const Color &farNameColor = closeNameColor.Transparent(.5);
+	const Font &nameFont = FontSet::Get(18);
 	for(const auto &it : GameData::Systems())
 	{
 		const System &system = it.second;
@@ -829,14 +845,17 @@ void MapPanel::UpdateCache()
 			}
 		}
 		
-		nodes.emplace_back(system.Position(), color,
-			player.KnowsName(system) ? system.Name() : "",
+		const string &name = player.KnowsName(system) ? system.Name() : "";
+		nodes.emplace(&system, Node(system.Position(), name,
 			(&system == &playerSystem) ? closeNameColor : farNameColor,
-			player.HasVisited(system) ? system.GetGovernment() : nullptr);
+			player.HasVisited(system) ? system.GetGovernment() : nullptr));
+		nameWidth = max(nameWidth, LabelWidth(system, name, nameFont));
+		shapes.AddMapRing(system.Position(), OUTER, INNER, color);
 	}
+	systemRings.Set(shapes);
 	
 	// Now, update the cache of the links.
-	links.clear();
+	shapes.Clear();
 	
 	// The link color depends on whether it's connected to the current system or not.
 	const Color &closeColor = *GameData::Colors().Get("map link");
@@ -857,9 +876,10 @@ void MapPanel::UpdateCache()
 					continue;
 				
 				bool isClose = (system == &playerSystem || link == &playerSystem);
-				links.emplace_back(system->Position(), link->Position(), isClose ? closeColor : farColor);
+				shapes.AddMapLine(system->Position(), link->Position(), LINK_OFFSET, LINK_WIDTH, isClose ? closeColor : farColor);
 			}
 	}
+	links.Set(shapes);
 }
 
 
@@ -1050,45 +1070,33 @@ void MapPanel::DrawWormholes()
 
 void MapPanel::DrawLinks()
 {
-	double zoom = Zoom();
-	for(const Link &link : links)
-	{
-		Point from = zoom * (link.start + center);
-		Point to = zoom * (link.end + center);
-		Point unit = (from - to).Unit() * LINK_OFFSET;
-		from -= unit;
-		to += unit;
-		
-		LineShader::Draw(from, to, LINK_WIDTH, link.color);
-	}
+	links.Draw(center, Zoom());
 }
 
 
 
 void MapPanel::DrawSystems()
 {
-	if(commodity != cachedCommodity)
-		UpdateCache();
+	// Draw the circles for the systems.
+	double zoom = Zoom();
+	systemRings.Draw(center, zoom);
 	
 	// If coloring by government, we need to keep track of which ones are the
 	// closest to the center of the window because those will be the ones that
 	// are shown in the map key.
-	if(commodity == SHOW_GOVERNMENT)
-		closeGovernments.clear();
+	if(commodity != SHOW_GOVERNMENT)
+		return;
 	
-	// Draw the circles for the systems.
-	double zoom = Zoom();
-	for(const Node &node : nodes)
+	closeGovernments.clear();
+	for(const auto &it : nodes)
 	{
-		Point pos = zoom * (node.position + center);
-		RingShader::Draw(pos, OUTER, INNER, node.color);
-		
-		if(commodity == SHOW_GOVERNMENT && node.government && node.government->GetName() != "Uninhabited")
+		const Node &node = it.second;
+		if(node.government && node.government->GetName() != "Uninhabited")
 		{
 			// For every government that is drawn, keep track of how close it
 			// is to the center of the view. The four closest governments
 			// will be displayed in the key.
-			double distance = pos.Length();
+			double distance = (zoom * (node.position + center)).Length();
 			auto it = closeGovernments.find(node.government);
 			if(it == closeGovernments.end())
 				closeGovernments[node.government] = distance;
@@ -1111,8 +1119,19 @@ void MapPanel::DrawNames()
 	bool useBigFont = (zoom > 2.);
 	const Font &font = FontSet::Get(useBigFont ? 18 : 14);
 	Point offset(useBigFont ? 8. : 6., -.5 * font.Height());
-	for(const Node &node : nodes)
+	// Only look at the systems whose names might be at least partly on screen.
+	Point topLeft = Screen::TopLeft() - offset - Point(nameWidth, font.Height());
+	Point bottomRight = Screen::BottomRight() - offset;
+	Rectangle area = Rectangle::WithCorners(topLeft / zoom - center, bottomRight / zoom - center);
+	for(const System *system : GameData::SystemLocations().Inside(area))
+	{
+		auto it = nodes.find(system);
+		if(it == nodes.end())
+			continue;
+		
+		const Node &node = it->second;
 		font.Draw(node.name, zoom * (node.position + center) + offset, node.nameColor);
+	}
 }
 
 
@@ -1242,3 +1261,23 @@ void MapPanel::DrawPointer(Point position, Angle &angle, const Color &color, boo
 		PointerShader::Draw(position, angle.Unit(), 14.f + bigger, 19.f + 2 * bigger, -4.f, black);
 	PointerShader::Draw(position, angle.Unit(), 8.f + bigger, 15.f + 2 * bigger, -6.f, color);
 }
+
+
+
+// Get the width of the label for the given system, measuring it only if
+// the name shown for it or the font's settings have changed.
+double MapPanel::LabelWidth(const System &system, const string &name, const Font &font)
+{
+	if(name.empty())
+		return 0.;
+	
+	if(labelGeneration != font.Generation())
+	{
+		labels.clear();
+		labelGeneration = font.Generation();
+	}
+	Label &label = labels[&system];
+	if(label.name != name)
+		label = Label{name, font.Width(name)};
+	return label.width;
+}
@@ -18,6 +18,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "Color.h"
 #include "DistanceMap.h"
 #include "Point.h"
+#include "PrimitiveBuffer.h"
 
 #include <map>
 #include <string>
@@ -25,6 +26,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include <vector>
 
 class Angle;
+class Font;
 class Government;
 class Mission;
 class Planet;
@@ -152,6 +154,9 @@ private:
 	void DrawTooltips();
 	void DrawPointer(const System *system, Angle &angle, const Color &color, bool bigger = false);
 	static void DrawPointer(Point position, Angle &angle, const Color &color, bool drawBack = true, bool bigger = false);
+	// Get the width of the label for the given system, measuring it only if
+	// the name shown for it or the font's settings have changed.
+	double LabelWidth(const System &system, const std::string &name, const Font &font);
 	
 	
 private:
@@ -160,27 +165,32 @@ private:
 	
 	class Node {
 	public:
-		Node(const Point &position, const Color &color, const std::string &name, const Color &nameColor, const Government *government)
-			: position(position), color(color), name(name), nameColor(nameColor), government(government) {}
+		Node(const Point &position, const std::string &name, const Color &nameColor, const Government *government)
+			: position(position), name(name), nameColor(nameColor), government(government) {}
 		
 		Point position;
-		Color color;
 		std::string name;
 		Color nameColor;
 		const Government *government;
 	};
-	std::vector<Node> nodes;
-	
-	class Link {
+	std::map<const System *, Node> nodes;
+	// The width of the longest system name, in the largest font used on the map.
+	double nameWidth = 0.;
+	// The width of each system's label, which is only measured again if the
+	// name shown for that system changes, or the font generation it was
+	// measured with is no longer current (e.g. after the language changes).
+	class Label {
 	public:
-		Link(const Point &start, const Point &end, const Color &color)
-			: start(start), end(end), color(color) {}
-		
-		Point start;
-		Point end;
-		Color color;
+		std::string name;
+		int width;
 	};
-	std::vector<Link> links;
+	std::map<const System *, Label> labels;
+	int labelGeneration = 0;
+	
+	// The rings of the systems and the links between them are kept in video
+	// memory, and only rebuilt when the cache is updated.
+	PrimitiveBuffer systemRings;
+	PrimitiveBuffer links;
 };
 
 
@@ -0,0 +1,94 @@
+/* MappedFile.cpp
+Copyright (c) 2021 by Michael Zahniser
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "MappedFile.h"
+
+#include "File.h"
+
+#if defined _WIN32
+#include <io.h>
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+using namespace std;
+
+
+
+MappedFile::MappedFile(const string &path)
+{
+	// Open the file the same way as any other file, so that the path is
+	// interpreted the same way on all platforms. The mapping stays valid
+	// after the file itself is closed.
+	File file(path);
+	if(!file)
+		return;
+	
+#if defined _WIN32
+	HANDLE handle = reinterpret_cast<HANDLE>(_get_osfhandle(_fileno(file)));
+	LARGE_INTEGER fileSize;
+	if(!GetFileSizeEx(handle, &fileSize) || !fileSize.QuadPart)
+		return;
+	
+	HANDLE mapping = CreateFileMappingW(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if(!mapping)
+		return;
+	const void *view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	CloseHandle(mapping);
+	if(!view)
+		return;
+	
+	size = fileSize.QuadPart;
+#else
+	int fd = fileno(file);
+	struct stat buf;
+	if(fstat(fd, &buf) || buf.st_size <= 0)
+		return;
+	
+	const void *view = mmap(nullptr, buf.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	if(view == MAP_FAILED)
+		return;
+	
+	size = buf.st_size;
+#endif
+	data = static_cast<const char *>(view);
+}
+
+
+
+MappedFile::~MappedFile()
+{
+	if(!data)
+		return;
+	
+#if defined _WIN32
+	UnmapViewOfFile(data);
+#else
+	munmap(const_cast<char *>(data), size);
+#endif
+}
+
+
+
+const char *MappedFile::Data() const
+{
+	return data;
+}
+
+
+
+size_t MappedFile::Size() const
+{
+	return size;
+}
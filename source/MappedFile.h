@@ -0,0 +1,45 @@
+/* MappedFile.h
+Copyright (c) 2021 by Michael Zahniser
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#ifndef MAPPED_FILE_H_
+#define MAPPED_FILE_H_
+
+#include <cstddef>
+#include <string>
+
+
+
+// RAII wrapper for a read-only memory mapping of a file, so its contents can
+// be parsed in place instead of first being copied into a string.
+class MappedFile {
+public:
+	MappedFile() = default;
+	explicit MappedFile(const std::string &path);
+	MappedFile(const MappedFile &) = delete;
+	~MappedFile();
+	
+	// Do not allow copying the mapping.
+	MappedFile &operator=(const MappedFile &) = delete;
+	
+	// If the file could not be opened or is empty, the size is zero.
+	const char *Data() const;
+	size_t Size() const;
+	
+	
+private:
+	const char *data = nullptr;
+	size_t size = 0;
+};
+
+
+
+#endif
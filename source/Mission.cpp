@@ -529,6 +529,30 @@ bool Mission::IsAtLocation(Location location) const
 
 
 
+// Get the planet this mission must be offered on (if any), the filter that
+// the planet or ship offering it must match, and the conditions that must
+// be satisfied to offer it.
+const Planet *Mission::SourcePlanet() const
+{
+	return source;
+}
+
+
+
+const LocationFilter &Mission::SourceFilter() const
+{
+	return sourceFilter;
+}
+
+
+
+const ConditionSet &Mission::ToOffer() const
+{
+	return toOffer;
+}
+
+
+
 // Information about what you are doing.
 const Planet *Mission::Destination() const
 {
@@ -685,12 +709,8 @@ bool Mission::CanOffer(const PlayerInfo &player, const shared_ptr<Ship> &boardin
 	if(!toFail.IsEmpty() && toFail.Test(player.Conditions()))
 		return false;
 	
-	if(repeat)
-	{
-		auto cit = player.Conditions().find(name + ": offered");
-		if(cit != player.Conditions().end() && cit->second >= repeat)
-			return false;
-	}
+	if(repeat && player.Conditions().Get(name + ": offered") >= repeat)
+		return false;
 	
 	auto it = actions.find(OFFER);
 	if(it != actions.end() && !it->second.CanBeDone(player, boardingShip))
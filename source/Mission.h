@@ -74,6 +74,12 @@ public:
 	// Find out where this mission is offered.
 	enum Location {SPACEPORT, LANDING, JOB, ASSISTING, BOARDING};
 	bool IsAtLocation(Location location) const;
+	// Get the planet this mission must be offered on (if any), the filter that
+	// the planet or ship offering it must match, and the conditions that must
+	// be satisfied to offer it.
+	const Planet *SourcePlanet() const;
+	const LocationFilter &SourceFilter() const;
+	const ConditionSet &ToOffer() const;
 	
 	// Information about what you are doing.
 	const Planet *Destination() const;
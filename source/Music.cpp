@@ -12,6 +12,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 
 #include "Music.h"
 
+#include "DirectoryCache.h"
 #include "Files.h"
 
 #include <mad.h>
@@ -40,7 +41,7 @@ void Music::Init(const vector<string> &sources)
 	{
 		// Find all the sound files that this resource source provides.
 		string root = source + "sounds/";
-		vector<string> files = Files::RecursiveList(root);
+		vector<string> files = DirectoryCache::RecursiveList(root);
 		
 		for(const string &path : files)
 		{
@@ -0,0 +1,180 @@
+/* OfferIndex.cpp
+Copyright (c) 2021 by Michael Zahniser
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "OfferIndex.h"
+
+#include "ConditionSet.h"
+#include "ConditionsStore.h"
+#include "GameData.h"
+#include "LocationFilter.h"
+#include "Planet.h"
+
+#include <algorithm>
+
+using namespace std;
+
+
+
+// Index the missions in the given set instead of GameData::Missions().
+OfferIndex::OfferIndex(const Set<Mission> &missions)
+	: source(&missions)
+{
+}
+
+
+
+// Get the missions that might be offered on the given planet, in the same
+// order as GameData::Missions(). Jobs are only included if asked for. The
+// conditions must always be the player's conditions.
+vector<const Mission *> OfferIndex::Missions(const Planet *planet, bool withJobs, const ConditionsStore &conditions)
+{
+	// A mission's source filter never matches if there is no planet.
+	if(!planet)
+		return vector<const Mission *>();
+	
+	Build();
+	vector<int> indices = anywhere;
+	auto it = byPlanet.find(planet);
+	if(it != byPlanet.end())
+		indices.insert(indices.end(), it->second.begin(), it->second.end());
+	auto sit = bySystem.find(planet->GetSystem());
+	if(sit != bySystem.end())
+		indices.insert(indices.end(), sit->second.begin(), sit->second.end());
+	for(const string &attribute : planet->Attributes())
+	{
+		auto ait = byAttribute.find(attribute);
+		if(ait != byAttribute.end())
+			indices.insert(indices.end(), ait->second.begin(), ait->second.end());
+	}
+	// A mission may be in the buckets of several of the planet's attributes.
+	sort(indices.begin(), indices.end());
+	indices.erase(unique(indices.begin(), indices.end()), indices.end());
+	
+	return Test(indices, withJobs, conditions);
+}
+
+
+
+// Get the missions that might be offered when boarding or assisting a ship.
+vector<const Mission *> OfferIndex::Missions(Mission::Location location, const ConditionsStore &conditions)
+{
+	Build();
+	auto it = byShip.find(location);
+	if(it == byShip.end())
+		return vector<const Mission *>();
+	
+	return Test(it->second, false, conditions);
+}
+
+
+
+// Sort all the missions into buckets.
+void OfferIndex::Build()
+{
+	// The missions that are defined do not change once the game data is loaded.
+	const auto &missions = source ? *source : GameData::Missions();
+	if(static_cast<int>(entries.size()) == missions.size())
+		return;
+	
+	const Set<Mission> *source = this->source;
+	*this = OfferIndex();
+	this->source = source;
+	for(const auto &it : missions)
+	{
+		const Mission &mission = it.second;
+		int index = entries.size();
+		
+		vector<int> slots;
+		bool canRemember = mission.ToOffer().ListSlots(slots);
+		entries.push_back(Entry{&mission, canRemember, false});
+		if(canRemember)
+		{
+			sort(slots.begin(), slots.end());
+			slots.erase(unique(slots.begin(), slots.end()), slots.end());
+			for(int slot : slots)
+				readers[slot].push_back(index);
+		}
+		
+		if(mission.IsAtLocation(Mission::BOARDING) || mission.IsAtLocation(Mission::ASSISTING))
+		{
+			byShip[mission.IsAtLocation(Mission::BOARDING) ? Mission::BOARDING : Mission::ASSISTING].push_back(index);
+			continue;
+		}
+		
+		// Use the most specific requirement there is. Any of the sets of
+		// attributes will do, since the planet must have one from each.
+		const LocationFilter &filter = mission.SourceFilter();
+		if(mission.SourcePlanet())
+			byPlanet[mission.SourcePlanet()].push_back(index);
+		else if(!filter.Planets().empty())
+			for(const Planet *planet : filter.Planets())
+				byPlanet[planet].push_back(index);
+		else if(!filter.Systems().empty())
+			for(const System *system : filter.Systems())
+				bySystem[system].push_back(index);
+		else if(!filter.Attributes().empty())
+			for(const string &attribute : filter.Attributes().front())
+				byAttribute[attribute].push_back(index);
+		else
+			anywhere.push_back(index);
+	}
+}
+
+
+
+// Forget that the offer tests of any missions failed if the conditions
+// they read may have changed since they were tested.
+void OfferIndex::Update(const ConditionsStore &conditions)
+{
+	vector<int> slots;
+	if(this->conditions != &conditions || !conditions.Changed(stamp, slots))
+	{
+		for(Entry &entry : entries)
+			entry.hasFailed = false;
+	}
+	else
+		for(int slot : slots)
+		{
+			auto it = readers.find(slot);
+			if(it != readers.end())
+				for(int index : it->second)
+					entries[index].hasFailed = false;
+		}
+	
+	this->conditions = &conditions;
+	stamp = conditions.Stamp();
+}
+
+
+
+// Get the missions with the given indices whose offer tests pass or
+// depend on random numbers.
+vector<const Mission *> OfferIndex::Test(const vector<int> &indices, bool withJobs, const ConditionsStore &conditions)
+{
+	Update(conditions);
+	
+	vector<const Mission *> result;
+	for(int index : indices)
+	{
+		Entry &entry = entries[index];
+		if(entry.hasFailed || (!withJobs && entry.mission->IsAtLocation(Mission::JOB)))
+			continue;
+		
+		// Mission::CanOffer() tests the conditions again, so testing a random
+		// condition here too would make the mission less likely to be offered.
+		if(!entry.canRemember || entry.mission->ToOffer().Test(conditions))
+			result.push_back(entry.mission);
+		else
+			entry.hasFailed = true;
+	}
+	return result;
+}
@@ -0,0 +1,102 @@
+/* OfferIndex.h
+Copyright (c) 2021 by Michael Zahniser
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#ifndef OFFER_INDEX_H_
+#define OFFER_INDEX_H_
+
+#include "Mission.h"
+#include "Set.h"
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+class ConditionsStore;
+class Planet;
+class System;
+
+
+
+// Class for finding which missions might be offered in a given place, without
+// checking every mission that is defined. Missions are sorted into buckets by
+// where they are offered, and by which planets, systems, or attributes their
+// source filters require. The index also remembers which missions' offer
+// conditions were not satisfied, and which conditions those tests read, so a
+// mission is only tested again once one of those conditions has changed.
+// Missions whose offer tests depend on random numbers are never tested here,
+// so that they are only rolled for once. The missions it returns must still be
+// checked with Mission::CanOffer().
+class OfferIndex {
+public:
+	// Index the missions in GameData::Missions(), or in the given set.
+	OfferIndex() = default;
+	explicit OfferIndex(const Set<Mission> &missions);
+	
+	// Get the missions that might be offered on the given planet, in the same
+	// order as GameData::Missions(). Jobs are only included if asked for. The
+	// conditions must always be the player's conditions.
+	std::vector<const Mission *> Missions(const Planet *planet, bool withJobs, const ConditionsStore &conditions);
+	// Get the missions that might be offered when boarding or assisting a ship.
+	std::vector<const Mission *> Missions(Mission::Location location, const ConditionsStore &conditions);
+	
+	
+private:
+	// Sort all the missions into buckets.
+	void Build();
+	// Forget that the offer tests of any missions failed if the conditions
+	// they read may have changed since they were tested.
+	void Update(const ConditionsStore &conditions);
+	// Get the missions with the given indices whose offer tests pass or
+	// depend on random numbers.
+	std::vector<const Mission *> Test(const std::vector<int> &indices, bool withJobs, const ConditionsStore &conditions);
+	
+	
+private:
+	class Entry {
+	public:
+		const Mission *mission;
+		// Whether the result of the offer test only depends on the values of
+		// the conditions it reads, and not on random numbers.
+		bool canRemember;
+		// Whether the offer test failed, and nothing it reads has changed.
+		bool hasFailed;
+	};
+	
+	
+private:
+	// The missions to index, if not the ones in GameData::Missions().
+	const Set<Mission> *source = nullptr;
+	// Every mission, in the same order as GameData::Missions().
+	std::vector<Entry> entries;
+	
+	// The indices of the missions that are offered on planets, sorted by the
+	// planet they must be offered on, the system that planet must be in, or
+	// one of the attributes that planet must have. Missions whose source
+	// filters do not restrict any of those can be offered anywhere.
+	std::map<const Planet *, std::vector<int>> byPlanet;
+	std::map<const System *, std::vector<int>> bySystem;
+	std::map<std::string, std::vector<int>> byAttribute;
+	std::vector<int> anywhere;
+	// The indices of the missions that are offered on ships.
+	std::map<Mission::Location, std::vector<int>> byShip;
+	
+	// The indices of the missions whose offer tests read each condition.
+	std::map<int, std::vector<int>> readers;
+	// The conditions the offer tests were last done with, and when.
+	const ConditionsStore *conditions = nullptr;
+	uint64_t stamp = 0;
+};
+
+
+
+#endif
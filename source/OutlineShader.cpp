@@ -153,6 +153,11 @@ void OutlineShader::Init()
 
 void OutlineShader::Draw(const Sprite *sprite, const Point &pos, const Point &size, const Color &color, const Point &unit, float frame)
 {
+	// Sprites that are still being loaded are not drawn.
+	uint32_t texture = sprite->Texture(unit.Length() * Screen::Zoom() > 50.);
+	if(!texture)
+		return;
+	
 	glUseProgram(shader.Object());
 	glBindVertexArray(vao);
 	
@@ -183,7 +188,7 @@ void OutlineShader::Draw(const Sprite *sprite, const Point &pos, const Point &si
 	
 	glUniform4fv(colorI, 1, color.Get());
 	
-	glBindTexture(GL_TEXTURE_2D_ARRAY, sprite->Texture(unit.Length() * Screen::Zoom() > 50.));
+	glBindTexture(GL_TEXTURE_2D_ARRAY, texture);
 	
 	glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
 	
@@ -230,6 +230,7 @@ void Planet::Load(const DataNode &node)
 	// Precalculate commonly used values that can only change due to Load().
 	inhabited = (HasSpaceport() || requiredReputation || !defenseFleets.empty()) && !attributes.count("uninhabited");
 	SetRequiredAttributes(Attributes(), requiredAttributes);
+	attributeBits = AttributeBits(attributes);
 }
 
 
@@ -304,6 +305,14 @@ const set<string> &Planet::Attributes() const
 
 
 
+// Get the same attributes as a bitset, for location filters.
+const AttributeBits &Planet::GetAttributeBits() const
+{
+	return attributeBits;
+}
+
+
+
 // Get planet's noun descriptor from attributes
 // This function may return a translated text.
 string Planet::Noun() const
@@ -13,6 +13,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #ifndef PLANET_H_
 #define PLANET_H_
 
+#include "AttributeBits.h"
 #include "text/Gettext.h"
 #include "Sale.h"
 
@@ -63,6 +64,8 @@ public:
 	
 	// Get the list of "attributes" of the planet.
 	const std::set<std::string> &Attributes() const;
+	// Get the same attributes as a bitset, for location filters.
+	const AttributeBits &GetAttributeBits() const;
 	
 	// Get planet's noun descriptor from attributes
 	// This function may return a translated text.
@@ -149,6 +152,7 @@ private:
 	std::string music;
 	
 	std::set<std::string> attributes;
+	AttributeBits attributeBits;
 	
 	std::set<const Sale<Ship> *> shipSales;
 	std::set<const Sale<Outfit> *> outfitSales;
@@ -36,10 +36,12 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "SavedGame.h"
 #include "Ship.h"
 #include "ShipEvent.h"
+#include "Sprite.h"
 #include "StartConditions.h"
 #include "StellarObject.h"
 #include "System.h"
 #include "UI.h"
+#include "WriteQueue.h"
 
 #include <algorithm>
 #include <cmath>
@@ -351,6 +353,8 @@ void PlayerInfo::Save() const
 	// Remember that this was the most recently saved player.
 	Files::Write(Files::Config() + "recent.txt", filePath + '\n');
 	
+	// Any earlier save must be written before the backups can be updated.
+	WriteQueue::Finish();
 	if(filePath.rfind(".txt") == filePath.length() - 4)
 	{
 		// Only update the backups if this save will have a newer date.
@@ -566,11 +570,8 @@ void PlayerInfo::IncrementDate()
 	int64_t total[2] = {0, 0};
 	static const string prefix[2] = {"salary: ", "tribute: "};
 	for(int i = 0; i < 2; ++i)
-	{
-		auto it = conditions.lower_bound(prefix[i]);
-		for( ; it != conditions.end() && !it->first.compare(0, prefix[i].length(), prefix[i]); ++it)
-			total[i] += it->second;
-	}
+		for(const auto &it : conditions.List(prefix[i]))
+			total[i] += it.second;
 	if(total[0] || total[1])
 	{
 		string message = T("You receive ");
@@ -1638,10 +1639,10 @@ Mission *PlayerInfo::BoardingMission(const shared_ptr<Ship> &ship)
 			? Mission::BOARDING : Mission::ASSISTING);
 	
 	// Check for available boarding or assisting missions.
-	for(const auto &it : GameData::Missions())
-		if(it.second.IsAtLocation(location) && it.second.CanOffer(*this, ship))
+	for(const Mission *mission : offers.Missions(location, conditions))
+		if(mission->CanOffer(*this, ship))
 		{
-			boardingMissions.push_back(it.second.Instantiate(*this, ship));
+			boardingMissions.push_back(mission->Instantiate(*this, ship));
 			if(boardingMissions.back().HasFailed(*this))
 				boardingMissions.pop_back();
 			else
@@ -1809,14 +1810,13 @@ void PlayerInfo::HandleEvent(const ShipEvent &event, UI *ui)
 // Get the value of the given condition (default 0).
 int64_t PlayerInfo::GetCondition(const string &name) const
 {
-	auto it = conditions.find(name);
-	return (it == conditions.end()) ? 0 : it->second;
+	return conditions.Get(name);
 }
 
 
 
 // Get mutable access to the player's list of conditions.
-map<string, int64_t> &PlayerInfo::Conditions()
+ConditionsStore &PlayerInfo::Conditions()
 {
 	return conditions;
 }
@@ -1824,7 +1824,7 @@ map<string, int64_t> &PlayerInfo::Conditions()
 
 
 // Access the player's list of conditions.
-const map<string, int64_t> &PlayerInfo::Conditions() const
+const ConditionsStore &PlayerInfo::Conditions() const
 {
 	return conditions;
 }
@@ -2367,12 +2367,9 @@ void PlayerInfo::ApplyChanges()
 	
 	// Check which planets you have dominated.
 	static const string prefix = "tribute: ";
-	for(auto it = conditions.lower_bound(prefix); it != conditions.end(); ++it)
+	for(const auto &it : conditions.List(prefix))
 	{
-		if(it->first.compare(0, prefix.length(), prefix))
-			break;
-		
-		const Planet *planet = GameData::Planets().Find(it->first.substr(prefix.length()));
+		const Planet *planet = GameData::Planets().Find(it.first.substr(prefix.length()));
 		if(planet)
 			GameData::GetPolitics().DominatePlanet(planet);
 	}
@@ -2512,16 +2509,8 @@ void PlayerInfo::UpdateAutoConditions(bool isBoarding)
 	conditions["credit score"] = accounts.CreditScore();
 	// Serialize the current reputation with other governments.
 	SetReputationConditions();
-	// Helper lambda function to clear a range
-	auto clearRange = [](map<string, int64_t> &conditionsMap, string firstStr, string lastStr)
-	{
-		auto first = conditionsMap.lower_bound(firstStr);
-		auto last = conditionsMap.lower_bound(lastStr);
-		if(first != last)
-			conditionsMap.erase(first, last);
-	};
-	// Clear any existing ships: conditions. (Note: '!' = ' ' + 1.)
-	clearRange(conditions, "ships: ", "ships:!");
+	// Clear any existing ships: conditions.
+	conditions.ErasePrefix("ships: ");
 	// Store special conditions for cargo and passenger space.
 	conditions["cargo space"] = 0;
 	conditions["passenger space"] = 0;
@@ -2541,9 +2530,9 @@ void PlayerInfo::UpdateAutoConditions(bool isBoarding)
 		conditions["passenger space"] = flagship->Cargo().BunksFree();
 	}
 	
-	// Clear any existing flagship system: and planet: conditions. (Note: '!' = ' ' + 1.)
-	clearRange(conditions, "flagship system: ", "flagship system:!");
-	clearRange(conditions, "flagship planet: ", "flagship planet:!");
+	// Clear any existing flagship system: and planet: conditions.
+	conditions.ErasePrefix("flagship system: ");
+	conditions.ErasePrefix("flagship planet: ");
 	
 	// Store conditions for flagship current crew, required crew, and bunks.
 	if(flagship)
@@ -2580,22 +2569,17 @@ void PlayerInfo::CreateMissions()
 	// Check for available missions.
 	bool skipJobs = planet && !planet->IsInhabited();
 	bool hasPriorityMissions = false;
-	for(const auto &it : GameData::Missions())
+	for(const Mission *mission : offers.Missions(planet, !skipJobs, conditions))
 	{
-		if(it.second.IsAtLocation(Mission::BOARDING) || it.second.IsAtLocation(Mission::ASSISTING))
-			continue;
-		if(skipJobs && it.second.IsAtLocation(Mission::JOB))
-			continue;
-		
-		if(it.second.CanOffer(*this))
+		if(mission->CanOffer(*this))
 		{
 			list<Mission> &missions =
-				it.second.IsAtLocation(Mission::JOB) ? availableJobs : availableMissions;
+				mission->IsAtLocation(Mission::JOB) ? availableJobs : availableMissions;
 			
-			missions.push_back(it.second.Instantiate(*this));
+			missions.push_back(mission->Instantiate(*this));
 			if(missions.back().HasFailed(*this))
 				missions.pop_back();
-			else if(!it.second.IsAtLocation(Mission::JOB))
+			else if(!mission->IsAtLocation(Mission::JOB))
 				hasPriorityMissions |= missions.back().HasPriority();
 		}
 	}
@@ -2742,9 +2726,12 @@ void PlayerInfo::Autosave() const
 
 
 
+// Save the player to the given path. The save file is written in the
+// background, so that saving a large file does not pause the game. It is
+// compressed if the player has chosen to compress saved games.
 void PlayerInfo::Save(const string &path) const
 {
-	DataWriter out(path);
+	DataWriter out("");
 	
 	
 	// Basic player information and persistent UI settings:
@@ -2760,6 +2747,20 @@ void PlayerInfo::Save(const string &path) const
 	if(planet && planet->CanUseServices())
 		out.Write("clearance");
 	out.Write("playtime", playTime);
+	// Summarize what the load panel shows from the rest of the file, so that it
+	// only needs to read the beginning of it.
+	out.Write("summary");
+	out.BeginChild();
+	{
+		out.Write("credits", accounts.Credits());
+		for(const shared_ptr<Ship> &ship : ships)
+			if(ship->GetSprite())
+			{
+				out.Write("ship", FontUtilities::Unescape(ship->Name()), ship->GetSprite()->Name());
+				break;
+			}
+	}
+	out.EndChild();
 	// This flag is set if the player must leave the planet immediately upon
 	// entering their ship (i.e. because a mission forced them to take off).
 	if(shouldLaunch)
@@ -2880,12 +2881,12 @@ void PlayerInfo::Save(const string &path) const
 		mission.Save(out, "available mission");
 	
 	// Save any "condition" flags that are set.
-	if(!conditions.empty())
+	if(!conditions.IsEmpty())
 	{
 		out.Write("conditions");
 		out.BeginChild();
 		{
-			for(const auto &it : conditions)
+			for(const auto &it : conditions.List())
 			{
 				// If the condition's value is 1, don't bother writing the 1.
 				if(it.second == 1)
@@ -2995,6 +2996,8 @@ void PlayerInfo::Save(const string &path) const
 	out.Write();
 	out.WriteComment("How you began:");
 	startData.Save(out);
+	
+	WriteQueue::Add(path, out.GetString(), Preferences::Has("Compress saved games"));
 }
 
 
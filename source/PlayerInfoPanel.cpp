@@ -56,14 +56,9 @@ namespace {
 	{
 		vector<pair<int64_t, string>> match;
 		
-		auto it = player.Conditions().lower_bound(prefix);
-		for( ; it != player.Conditions().end(); ++it)
-		{
-			if(it->first.compare(0, prefix.length(), prefix))
-				break;
-			if(it->second > 0)
-				match.emplace_back(it->second, conv(it->first.substr(prefix.length()) + suffix));
-		}
+		for(const auto &it : player.Conditions().List(prefix))
+			if(it.second > 0)
+				match.emplace_back(it.second, conv(it.first.substr(prefix.length()) + suffix));
 		return match;
 	}
 	
@@ -462,6 +462,7 @@ void PreferencesPanel::DrawSettings()
 		G("Draw starfield"),
 		G("Show hyperspace flash"),
 		SHIP_OUTLINES,
+		G("Compress saved games"),
 		"",
 		G("Other"),
 		G("Clickable radar display"),
@@ -0,0 +1,91 @@
+/* PrimitiveBuffer.cpp
+Copyright (c) 2021 by Michael Zahniser
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "PrimitiveBuffer.h"
+
+#include "Point.h"
+#include "PrimitiveDrawList.h"
+#include "PrimitiveShader.h"
+
+using namespace std;
+
+
+
+// The video memory buffers are not shared between copies.
+PrimitiveBuffer::PrimitiveBuffer(const PrimitiveBuffer &other)
+	: data(other.data)
+{
+}
+
+
+
+PrimitiveBuffer &PrimitiveBuffer::operator=(const PrimitiveBuffer &other)
+{
+	data = other.data;
+	isUploaded = false;
+	return *this;
+}
+
+
+
+PrimitiveBuffer::~PrimitiveBuffer()
+{
+	if(vbo)
+	{
+		glDeleteBuffers(1, &vbo);
+		glDeleteVertexArrays(1, &vao);
+	}
+}
+
+
+
+// Replace the contents of this buffer with the shapes in the given list.
+// They are uploaded the next time the buffer is drawn.
+void PrimitiveBuffer::Set(const PrimitiveDrawList &list)
+{
+	data = list.data;
+	isUploaded = false;
+}
+
+
+
+// Draw the shapes, with their map positions drawn at (position + center) * zoom.
+void PrimitiveBuffer::Draw(const Point &center, double zoom)
+{
+	if(data.empty())
+		return;
+	
+	PrimitiveShader::Bind(center, zoom);
+	if(!vbo)
+	{
+		// Create the buffer the first time it is drawn.
+		glGenVertexArrays(1, &vao);
+		glBindVertexArray(vao);
+		
+		glGenBuffers(1, &vbo);
+		glBindBuffer(GL_ARRAY_BUFFER, vbo);
+		PrimitiveShader::SetAttributes();
+	}
+	else
+	{
+		glBindVertexArray(vao);
+		glBindBuffer(GL_ARRAY_BUFFER, vbo);
+	}
+	if(!isUploaded)
+	{
+		glBufferData(GL_ARRAY_BUFFER, sizeof(float) * data.size(), data.data(), GL_STATIC_DRAW);
+		isUploaded = true;
+	}
+	
+	glDrawArrays(GL_TRIANGLES, 0, data.size() / PrimitiveShader::VERTEX_SIZE);
+	PrimitiveShader::Unbind();
+}
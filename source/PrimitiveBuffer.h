@@ -0,0 +1,53 @@
+/* PrimitiveBuffer.h
+Copyright (c) 2021 by Michael Zahniser
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#ifndef PRIMITIVE_BUFFER_H_
+#define PRIMITIVE_BUFFER_H_
+
+#include "gl_header.h"
+
+#include <vector>
+
+class PrimitiveDrawList;
+class Point;
+
+
+
+// Class holding the vertex data of a PrimitiveDrawList in video memory, so that
+// shapes which rarely change (like the links and systems on the map) only have
+// to be uploaded once, instead of every frame. Drawing the buffer takes a
+// constant amount of work no matter how many shapes it holds. A copy of the
+// data is kept, so that a copied buffer can upload it again.
+class PrimitiveBuffer {
+public:
+	PrimitiveBuffer() = default;
+	PrimitiveBuffer(const PrimitiveBuffer &other);
+	PrimitiveBuffer &operator=(const PrimitiveBuffer &other);
+	~PrimitiveBuffer();
+	
+	// Replace the contents of this buffer with the shapes in the given list.
+	// They are uploaded the next time the buffer is drawn.
+	void Set(const PrimitiveDrawList &list);
+	// Draw the shapes, with their map positions drawn at (position + center) * zoom.
+	void Draw(const Point &center, double zoom);
+	
+	
+private:
+	std::vector<float> data;
+	bool isUploaded = false;
+	
+	GLuint vao = 0;
+	GLuint vbo = 0;
+};
+
+
+#endif
@@ -0,0 +1,180 @@
+/* PrimitiveDrawList.cpp
+Copyright (c) 2021 by Michael Zahniser
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "PrimitiveDrawList.h"
+
+#include "Color.h"
+#include "pi.h"
+#include "Point.h"
+#include "PrimitiveShader.h"
+
+using namespace std;
+
+namespace {
+	// The two triangles making up a quad, as indices of its four corners
+	// in triangle strip order.
+	const int QUAD[6] = {0, 1, 2, 2, 1, 3};
+}
+
+
+
+// Clear the list.
+void PrimitiveDrawList::Clear()
+{
+	data.clear();
+}
+
+
+
+// Add a ring or a dot (RingShader).
+void PrimitiveDrawList::AddRing(const Point &pos, float out, float in, const Color &color)
+{
+	float width = .5f * (1.f + out - in) ;
+	AddRing(pos, out - width, width, 1.f, color);
+}
+
+
+
+void PrimitiveDrawList::AddRing(const Point &pos, float radius, float width, float fraction, const Color &color, float dash, float startAngle)
+{
+	AddRing(Point(), pos, radius, width, fraction, color, dash, startAngle);
+}
+
+
+
+// Add a triangular pointer (PointerShader).
+void PrimitiveDrawList::AddPointer(const Point &center, const Point &angle, float width, float height, float offset, const Color &color)
+{
+	static const Point CORNERS[3] = {Point(0., 0.), Point(0., 1.), Point(1., 0.)};
+	
+	const float params[4] = {width, height, 0.f, 0.f};
+	const Point side(angle.Y(), -angle.X());
+	for(const Point &vert : CORNERS)
+	{
+		Point base = center + angle * (offset - height * (vert.X() + vert.Y()));
+		Point wing = side * (width * .5 * (vert.X() - vert.Y()));
+		Point coord = vert * width;
+		Push(Point(), base + wing, coord.X(), coord.Y(), params, PrimitiveShader::POINTER, 0.f, color);
+	}
+}
+
+
+
+// Add a line (LineShader).
+void PrimitiveDrawList::AddLine(const Point &from, const Point &to, float width, const Color &color)
+{
+	static const Point CORNERS[4] = {Point(0., -1.), Point(1., -1.), Point(0., 1.), Point(1., 1.)};
+	
+	Point v = to - from;
+	Point u = v.Unit() * width;
+	Point w(u.Y(), -u.X());
+	const float params[4] = {static_cast<float>(v.Length()), 0.f, 0.f, 0.f};
+	for(int i : QUAD)
+	{
+		const Point &vert = CORNERS[i];
+		Push(Point(), from + vert.X() * v + vert.Y() * w, vert.X(), vert.Y(), params, PrimitiveShader::LINE, 0.f, color);
+	}
+}
+
+
+
+// Add a filled rectangle (FillShader).
+void PrimitiveDrawList::AddFill(const Point &center, const Point &size, const Color &color)
+{
+	static const Point CORNERS[4] = {Point(-.5, -.5), Point(.5, -.5), Point(-.5, .5), Point(.5, .5)};
+	
+	const float params[4] = {0.f, 0.f, 0.f, 0.f};
+	for(int i : QUAD)
+	{
+		const Point &vert = CORNERS[i];
+		Push(Point(), center + vert * size, 0.f, 0.f, params, PrimitiveShader::FILL, 0.f, color);
+	}
+}
+
+
+
+// Add a ring centered on the given map position. Its size is in pixels,
+// no matter how far the map is zoomed.
+void PrimitiveDrawList::AddMapRing(const Point &position, float out, float in, const Color &color)
+{
+	float width = .5f * (1.f + out - in);
+	AddRing(position, Point(), out - width, width, 1.f, color, 0.f, 0.f);
+}
+
+
+
+// Add a line between two map positions, leaving a gap of the given number
+// of pixels at either end.
+void PrimitiveDrawList::AddMapLine(const Point &from, const Point &to, float gap, float width, const Color &color)
+{
+	static const Point CORNERS[4] = {Point(0., -1.), Point(1., -1.), Point(0., 1.), Point(1., 1.)};
+	
+	// The on-screen length of the line is its length in map coordinates times
+	// the zoom, minus the two gaps.
+	Point v = to - from;
+	Point unit = v.Unit();
+	Point w = Point(unit.Y(), -unit.X()) * width;
+	const float params[4] = {-2.f * gap, static_cast<float>(v.Length()), 0.f, 0.f};
+	for(int i : QUAD)
+	{
+		const Point &vert = CORNERS[i];
+		Point offset = (1. - 2. * vert.X()) * gap * unit + vert.Y() * w;
+		Push(from + vert.X() * v, offset, vert.X(), vert.Y(), params, PrimitiveShader::LINE, 0.f, color);
+	}
+}
+
+
+
+// Draw all the shapes in this list.
+void PrimitiveDrawList::Draw() const
+{
+	if(data.empty())
+		return;
+	
+	PrimitiveShader::Bind();
+	PrimitiveShader::Add(data);
+	PrimitiveShader::Unbind();
+}
+
+
+
+// Add a vertex of a shape, at the given offset in pixels from the anchor.
+void PrimitiveDrawList::Push(const Point &anchor, const Point &vert, float s, float t, const float params[4], int shape, float extra, const Color &color)
+{
+	data.push_back(anchor.X());
+	data.push_back(anchor.Y());
+	data.push_back(vert.X());
+	data.push_back(vert.Y());
+	data.push_back(s);
+	data.push_back(t);
+	data.insert(data.end(), params, params + 4);
+	data.push_back(shape);
+	data.push_back(extra);
+	const float *rgba = color.Get();
+	data.insert(data.end(), rgba, rgba + 4);
+}
+
+
+
+void PrimitiveDrawList::AddRing(const Point &anchor, const Point &pos, float radius, float width, float fraction, const Color &color, float dash, float startAngle)
+{
+	static const Point CORNERS[4] = {Point(-1., -1.), Point(-1., 1.), Point(1., -1.), Point(1., 1.)};
+	
+	const float params[4] = {radius, width, static_cast<float>(fraction * 2. * PI),
+		static_cast<float>(startAngle * TO_RAD)};
+	const float dashAngle = dash ? 2. * PI / dash : 0.;
+	for(int i : QUAD)
+	{
+		Point coord = (radius + width) * CORNERS[i];
+		Push(anchor, pos + coord, coord.X(), coord.Y(), params, PrimitiveShader::RING, dashAngle, color);
+	}
+}
@@ -0,0 +1,72 @@
+/* PrimitiveDrawList.h
+Copyright (c) 2021 by Michael Zahniser
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#ifndef PRIMITIVE_DRAW_LIST_H_
+#define PRIMITIVE_DRAW_LIST_H_
+
+#include <vector>
+
+class Color;
+class Point;
+
+
+
+// This class collects the rings, pointers, lines, and rectangle fills that would
+// otherwise each be drawn with a separate call to their own shader, and draws
+// them all with a single command. The shapes are drawn in the order they were
+// added, so the result is the same as drawing each one when it was added, as
+// long as nothing else is drawn in between. The parameters of each function
+// are the same as those of the corresponding shader function. Shapes that are
+// placed on the map can be kept in a PrimitiveBuffer and drawn again in later
+// frames, at any position and zoom.
+class PrimitiveDrawList {
+public:
+	// Clear the list.
+	void Clear();
+	
+	// Add a ring or a dot (RingShader).
+	void AddRing(const Point &pos, float out, float in, const Color &color);
+	void AddRing(const Point &pos, float radius, float width, float fraction, const Color &color, float dash = 0.f, float startAngle = 0.f);
+	// Add a triangular pointer (PointerShader).
+	void AddPointer(const Point &center, const Point &angle, float width, float height, float offset, const Color &color);
+	// Add a line (LineShader).
+	void AddLine(const Point &from, const Point &to, float width, const Color &color);
+	// Add a filled rectangle (FillShader).
+	void AddFill(const Point &center, const Point &size, const Color &color);
+	
+	// Add a ring centered on the given map position. Its size is in pixels,
+	// no matter how far the map is zoomed.
+	void AddMapRing(const Point &position, float out, float in, const Color &color);
+	// Add a line between two map positions, leaving a gap of the given number
+	// of pixels at either end.
+	void AddMapLine(const Point &from, const Point &to, float gap, float width, const Color &color);
+	
+	// Draw all the shapes in this list.
+	void Draw() const;
+	
+	
+private:
+	// Add a vertex of a shape, at the given offset in pixels from the anchor.
+	void Push(const Point &anchor, const Point &vert, float s, float t, const float params[4], int shape, float extra, const Color &color);
+	void AddRing(const Point &anchor, const Point &pos, float radius, float width, float fraction, const Color &color, float dash, float startAngle);
+	
+	
+private:
+	// Each shape is drawn as one or two triangles of PrimitiveShader vertices.
+	std::vector<float> data;
+	
+	friend class PrimitiveBuffer;
+};
+
+
+
+#endif
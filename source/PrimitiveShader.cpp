@@ -0,0 +1,223 @@
+/* PrimitiveShader.cpp
+Copyright (c) 2021 by Michael Zahniser
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "PrimitiveShader.h"
+
+#include "Screen.h"
+#include "Shader.h"
+
+#include <stdexcept>
+
+using namespace std;
+
+namespace {
+	Shader shader;
+	// Uniforms:
+	GLint scaleI;
+	GLint centerI;
+	GLint zoomI;
+	// Vertex data:
+	GLint anchorI;
+	GLint vertI;
+	GLint coordI;
+	GLint paramsI;
+	GLint shapeI;
+	GLint colorI;
+	
+	GLuint vao;
+	GLuint vbo;
+}
+
+
+
+// Initialize the shaders.
+void PrimitiveShader::Init()
+{
+	static const char *vertexCode =
+		"// vertex primitive shader\n"
+		"uniform vec2 scale;\n"
+		"uniform vec2 center;\n"
+		"uniform float zoom;\n"
+		"in vec2 anchor;\n"
+		"in vec2 vert;\n"
+		"in vec2 coord;\n"
+		"in vec4 params;\n"
+		"in vec2 shape;\n"
+		"in vec4 color;\n"
+		
+		"out vec2 fragCoord;\n"
+		"flat out vec4 fragParams;\n"
+		"flat out vec2 fragShape;\n"
+		"flat out vec4 fragColor;\n"
+		
+		"void main() {\n"
+		"  gl_Position = vec4(((anchor + center) * zoom + vert) * scale, 0, 1);\n"
+		"  fragCoord = coord;\n"
+		"  fragParams = params;\n"
+		"  fragShape = shape;\n"
+		"  fragColor = color;\n"
+		"}\n";
+	
+	// The alpha of each shape type is calculated the same way as in the
+	// ring, pointer, and line shaders.
+	static const char *fragmentCode =
+		"// fragment primitive shader\n"
+		"const float pi = 3.1415926535897932384626433832795;\n"
+		"uniform float zoom;\n"
+		
+		"in vec2 fragCoord;\n"
+		"flat in vec4 fragParams;\n"
+		"flat in vec2 fragShape;\n"
+		"flat in vec4 fragColor;\n"
+		
+		"out vec4 finalColor;\n"
+		
+		"float ring() {\n"
+		"  float radius = fragParams.x;\n"
+		"  float width = fragParams.y;\n"
+		"  float angle = fragParams.z;\n"
+		"  float startAngle = fragParams.w;\n"
+		"  float dash = fragShape.y;\n"
+		"  float arc = mod(atan(fragCoord.x, fragCoord.y) + pi + startAngle, 2 * pi);\n"
+		"  float arcFalloff = 1 - min(2 * pi - arc, arc - angle) * radius;\n"
+		"  if(dash != 0)\n"
+		"  {\n"
+		"    arc = mod(arc, dash);\n"
+		"    arcFalloff = min(arcFalloff, min(arc, dash - arc) * radius);\n"
+		"  }\n"
+		"  float len = length(fragCoord);\n"
+		"  float lenFalloff = width - abs(len - radius);\n"
+		"  return clamp(min(arcFalloff, lenFalloff), 0, 1);\n"
+		"}\n"
+		
+		"float pointer() {\n"
+		"  float width = fragParams.x;\n"
+		"  float height = (fragCoord.x + fragCoord.y) / width;\n"
+		"  float taper = height * height * height;\n"
+		"  taper *= taper * .5 * width;\n"
+		"  float alpha = clamp(.8 * min(fragCoord.x, fragCoord.y) - taper, 0, 1);\n"
+		"  return alpha * clamp(1.8 * (1. - height), 0, 1);\n"
+		"}\n"
+		
+		"float line() {\n"
+		"  float tscale = fragParams.x + fragParams.y * zoom;\n"
+		"  return min(tscale - abs(fragCoord.x * (2 * tscale) - tscale), 1 - abs(fragCoord.y));\n"
+		"}\n"
+		
+		"void main() {\n"
+		"  float alpha = 1;\n"
+		"  if(fragShape.x == 1)\n"
+		"    alpha = ring();\n"
+		"  else if(fragShape.x == 2)\n"
+		"    alpha = pointer();\n"
+		"  else if(fragShape.x == 3)\n"
+		"    alpha = line();\n"
+		"  finalColor = fragColor * alpha;\n"
+		"}\n";
+	
+	// Compile the shaders.
+	shader = Shader(vertexCode, fragmentCode);
+	// Get the indices of the uniforms and attributes.
+	scaleI = shader.Uniform("scale");
+	centerI = shader.Uniform("center");
+	zoomI = shader.Uniform("zoom");
+	anchorI = shader.Attrib("anchor");
+	vertI = shader.Attrib("vert");
+	coordI = shader.Attrib("coord");
+	paramsI = shader.Attrib("params");
+	shapeI = shader.Attrib("shape");
+	colorI = shader.Attrib("color");
+	
+	// Generate the buffer for uploading the batch vertex data.
+	glGenVertexArrays(1, &vao);
+	glBindVertexArray(vao);
+	
+	glGenBuffers(1, &vbo);
+	glBindBuffer(GL_ARRAY_BUFFER, vbo);
+	
+	// In this VAO, enable the vertex arrays and specify their byte offsets.
+	SetAttributes();
+	
+	// Unbind the buffer and the VAO, but leave the vertex attrib arrays enabled
+	// in the VAO so they will be used when it is bound.
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindVertexArray(0);
+}
+
+
+
+void PrimitiveShader::Bind(const Point &center, float zoom)
+{
+	if(!shader.Object())
+		throw runtime_error("PrimitiveShader: Bind() called before Init().");
+	
+	glUseProgram(shader.Object());
+	glBindVertexArray(vao);
+	// Bind the vertex buffer so we can upload data to it.
+	glBindBuffer(GL_ARRAY_BUFFER, vbo);
+	
+	// Set up the screen scale.
+	GLfloat scale[2] = {2.f / Screen::Width(), -2.f / Screen::Height()};
+	glUniform2fv(scaleI, 1, scale);
+	// Set up the transform of the anchor points.
+	GLfloat centerV[2] = {static_cast<float>(center.X()), static_cast<float>(center.Y())};
+	glUniform2fv(centerI, 1, centerV);
+	glUniform1f(zoomI, zoom);
+}
+
+
+
+void PrimitiveShader::Add(const vector<float> &data)
+{
+	// Do nothing if there are no shapes to draw.
+	if(data.empty())
+		return;
+	
+	// Upload the vertex data.
+	glBufferData(GL_ARRAY_BUFFER, sizeof(float) * data.size(), data.data(), GL_STREAM_DRAW);
+	
+	// All the shapes are drawn as separate triangles, so they can be drawn
+	// with a single command.
+	glDrawArrays(GL_TRIANGLES, 0, data.size() / VERTEX_SIZE);
+}
+
+
+
+void PrimitiveShader::Unbind()
+{
+	// Unbind everything in reverse order.
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindVertexArray(0);
+	glUseProgram(0);
+}
+
+
+
+// Specify the layout of the vertex data in the currently bound vertex array
+// and buffer.
+void PrimitiveShader::SetAttributes()
+{
+	constexpr auto stride = VERTEX_SIZE * sizeof(float);
+	const auto offset = [](int floats) { return reinterpret_cast<const GLvoid *>(floats * sizeof(float)); };
+	glEnableVertexAttribArray(anchorI);
+	glVertexAttribPointer(anchorI, 2, GL_FLOAT, GL_FALSE, stride, nullptr);
+	glEnableVertexAttribArray(vertI);
+	glVertexAttribPointer(vertI, 2, GL_FLOAT, GL_FALSE, stride, offset(2));
+	glEnableVertexAttribArray(coordI);
+	glVertexAttribPointer(coordI, 2, GL_FLOAT, GL_FALSE, stride, offset(4));
+	glEnableVertexAttribArray(paramsI);
+	glVertexAttribPointer(paramsI, 4, GL_FLOAT, GL_FALSE, stride, offset(6));
+	glEnableVertexAttribArray(shapeI);
+	glVertexAttribPointer(shapeI, 2, GL_FLOAT, GL_FALSE, stride, offset(10));
+	glEnableVertexAttribArray(colorI);
+	glVertexAttribPointer(colorI, 4, GL_FLOAT, GL_FALSE, stride, offset(12));
+}
@@ -0,0 +1,61 @@
+/* PrimitiveShader.h
+Copyright (c) 2021 by Michael Zahniser
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#ifndef PRIMITIVE_SHADER_H_
+#define PRIMITIVE_SHADER_H_
+
+#include "Point.h"
+
+#include <vector>
+
+
+
+// Class for drawing the shapes of the ring, pointer, line, and fill shaders in
+// a batch. Each vertex carries the type and parameters of the shape it belongs
+// to, so any mix of shapes can be drawn with a single command. The vertex data
+// is built by the PrimitiveDrawList class. Each vertex is placed relative to an
+// "anchor" in map coordinates, which is transformed by the center and zoom given
+// to Bind(), so geometry that is kept in a PrimitiveBuffer can be panned and
+// zoomed without being rebuilt.
+class PrimitiveShader {
+public:
+	// The shape types understood by the fragment shader.
+	static const int FILL = 0;
+	static const int RING = 1;
+	static const int POINTER = 2;
+	static const int LINE = 3;
+	
+	// Each vertex has 16 attributes: (x, y) anchor in map coordinates, (x, y)
+	// offset from the anchor in pixels, (s, t) position within the shape, four
+	// shape parameters, the shape type and a fifth shape parameter, and the
+	// (r, g, b, a) color.
+	static const int VERTEX_SIZE = 16;
+	
+	
+public:
+	// Initialize the shaders.
+	static void Init();
+	
+	// Anchors are drawn at (anchor + center) * zoom. The default transform
+	// leaves them in screen coordinates.
+	static void Bind(const Point &center = Point(), float zoom = 1.f);
+	static void Add(const std::vector<float> &data);
+	static void Unbind();
+	
+	// Specify the layout of the vertex data in the currently bound vertex array
+	// and buffer.
+	static void SetAttributes();
+};
+
+
+
+#endif
@@ -0,0 +1,294 @@
+/* Profiler.cpp
+Copyright (c) 2021 by Michael Zahniser
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "Profiler.h"
+
+#include "Files.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+namespace {
+	class Event {
+	public:
+		string name;
+		string category;
+		string group;
+		int thread;
+		int64_t start;
+		int64_t duration;
+		int64_t bytes;
+	};
+	
+	// Only the slowest few spans in each category are listed in the summary.
+	const size_t SLOWEST_COUNT = 10;
+	
+	atomic<bool> isEnabled(false);
+	chrono::steady_clock::time_point origin;
+	
+	mutex eventMutex;
+	vector<Event> events;
+	// Threads are numbered in the order they first record anything, except
+	// that the thread that enabled the profiler is always thread 0.
+	map<thread::id, int> threads;
+	
+	// Get the time since the profiler was enabled, in microseconds.
+	int64_t Now()
+	{
+		return chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - origin).count();
+	}
+	
+	string Milliseconds(int64_t time)
+	{
+		ostringstream out;
+		out << fixed << setprecision(1) << time * .001;
+		return out.str();
+	}
+	
+	// Get the rate at which the given number of bytes were processed, in
+	// megabytes per second.
+	string Throughput(int64_t bytes, int64_t time)
+	{
+		ostringstream out;
+		out << fixed << setprecision(1) << (time ? bytes / (1.048576 * time) : 0.);
+		return out.str();
+	}
+	
+	string Escape(const string &text)
+	{
+		string result;
+		for(char c : text)
+		{
+			if(c == '"' || c == '\\')
+				result += '\\';
+			if(static_cast<unsigned char>(c) < 0x20)
+				result += ' ';
+			else
+				result += c;
+		}
+		return result;
+	}
+	
+	string ThreadName(int thread)
+	{
+		return thread ? "thread " + to_string(thread) : "main";
+	}
+}
+
+
+
+Profiler::Span::Span(const string &name, const string &category, const string &group)
+	: isRecording(isEnabled), start(0), bytes(0)
+{
+	// Don't bother copying anything if nothing is being recorded.
+	if(!isRecording)
+		return;
+	
+	this->name = name;
+	this->category = category;
+	this->group = group;
+	start = Now();
+}
+
+
+
+Profiler::Span::~Span()
+{
+	Record();
+}
+
+
+
+// End this span and begin a new one with the given name, in the same
+// category and group. This is convenient for timing a series of steps.
+void Profiler::Span::Next(const string &name)
+{
+	Record();
+	
+	isRecording = isEnabled;
+	if(!isRecording)
+		return;
+	
+	this->name = name;
+	start = Now();
+	bytes = 0;
+}
+
+
+
+// Record that this span processed the given number of bytes, so that
+// the throughput of its category can be reported.
+void Profiler::Span::AddBytes(int64_t bytes)
+{
+	this->bytes += bytes;
+}
+
+
+
+void Profiler::Span::Record()
+{
+	if(!isRecording)
+		return;
+	
+	int64_t end = Now();
+	lock_guard<mutex> lock(eventMutex);
+	// Check whether the profiler finished while this span was in progress.
+	if(!isEnabled)
+		return;
+	
+	auto it = threads.emplace(this_thread::get_id(), threads.size()).first;
+	events.push_back(Event{name, category, group, it->second, start, end - start, bytes});
+}
+
+
+
+// Begin recording. Times are measured from when this is called.
+void Profiler::Enable()
+{
+	lock_guard<mutex> lock(eventMutex);
+	origin = chrono::steady_clock::now();
+	threads.emplace(this_thread::get_id(), 0);
+	isEnabled = true;
+}
+
+
+
+bool Profiler::IsEnabled()
+{
+	return isEnabled;
+}
+
+
+
+// Stop recording, write everything recorded so far to the given path, and
+// print a summary of it.
+void Profiler::Finish(const string &path)
+{
+	vector<Event> recorded;
+	int threadCount = 0;
+	int64_t total = 0;
+	{
+		lock_guard<mutex> lock(eventMutex);
+		if(!isEnabled)
+			return;
+		isEnabled = false;
+		total = Now();
+		recorded.swap(events);
+		threadCount = threads.size();
+		threads.clear();
+	}
+	stable_sort(recorded.begin(), recorded.end(),
+		[](const Event &a, const Event &b) -> bool { return a.start < b.start; });
+	
+	// Write the trace. Each span is a "complete" event, with its start time
+	// and duration in microseconds, and each thread is given a name.
+	string trace = "{\"traceEvents\":[\n";
+	for(int i = 0; i < threadCount; ++i)
+		trace += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" + to_string(i)
+			+ ",\"args\":{\"name\":\"" + ThreadName(i) + "\"}},\n";
+	for(const Event &event : recorded)
+	{
+		trace += "{\"name\":\"" + Escape(event.name) + "\",\"cat\":\"" + Escape(event.category)
+			+ "\",\"ph\":\"X\",\"pid\":1,\"tid\":" + to_string(event.thread)
+			+ ",\"ts\":" + to_string(event.start) + ",\"dur\":" + to_string(event.duration);
+		if(!event.group.empty() || event.bytes)
+		{
+			trace += ",\"args\":{";
+			if(!event.group.empty())
+				trace += "\"group\":\"" + Escape(event.group) + (event.bytes ? "\"," : "\"");
+			if(event.bytes)
+				trace += "\"bytes\":" + to_string(event.bytes);
+			trace += "}";
+		}
+		trace += "},\n";
+	}
+	trace += "{\"name\":\"startup\",\"cat\":\"phase\",\"ph\":\"X\",\"pid\":1,\"tid\":0,\"ts\":0,\"dur\":"
+		+ to_string(total) + "}\n]}\n";
+	Files::Write(path, trace);
+	
+	// The summary lists each phase of loading in order, then how much time
+	// was spent on each other category of span and on each group within it,
+	// and finally the slowest spans of each category.
+	cout << "Startup profile written to \"" << path << "\"." << '\n';
+	cout << "phase" << '\t' << "thread" << '\t' << "start (ms)" << '\t' << "time (ms)" << '\n';
+	vector<string> categories;
+	map<string, pair<int, int64_t>> categoryTotals;
+	map<string, int64_t> categoryBytes;
+	map<pair<string, string>, pair<int, int64_t>> groupTotals;
+	for(const Event &event : recorded)
+	{
+		if(event.category == "phase")
+		{
+			cout << event.name << '\t' << ThreadName(event.thread) << '\t' << Milliseconds(event.start)
+				<< '\t' << Milliseconds(event.duration) << '\n';
+			continue;
+		}
+		pair<int, int64_t> &totals = categoryTotals[event.category];
+		if(!totals.first)
+			categories.push_back(event.category);
+		++totals.first;
+		totals.second += event.duration;
+		categoryBytes[event.category] += event.bytes;
+		if(!event.group.empty())
+		{
+			pair<int, int64_t> &group = groupTotals[make_pair(event.category, event.group)];
+			++group.first;
+			group.second += event.duration;
+		}
+	}
+	cout << "startup" << '\t' << ThreadName(0) << '\t' << Milliseconds(0) << '\t' << Milliseconds(total) << '\n';
+	
+	for(const string &category : categories)
+	{
+		const pair<int, int64_t> &totals = categoryTotals[category];
+		cout << '\n' << category << '\t' << "count" << '\t' << "time (ms)" << '\n';
+		cout << "total" << '\t' << totals.first << '\t' << Milliseconds(totals.second) << '\n';
+		int64_t bytes = categoryBytes[category];
+		if(bytes)
+			cout << "throughput (MB/s)" << '\t' << (bytes >> 20) << " MB" << '\t'
+				<< Throughput(bytes, totals.second) << '\n';
+		
+		// List the groups with the most time spent in them first.
+		vector<pair<int64_t, const string *>> groups;
+		for(const auto &it : groupTotals)
+			if(it.first.first == category)
+				groups.emplace_back(it.second.second, &it.first.second);
+		sort(groups.begin(), groups.end(), [](const pair<int64_t, const string *> &a, const pair<int64_t, const string *> &b)
+			-> bool { return a.first > b.first; });
+		for(const auto &it : groups)
+			cout << *it.second << '\t' << groupTotals[make_pair(category, *it.second)].first << '\t'
+				<< Milliseconds(it.first) << '\n';
+		
+		vector<const Event *> slowest;
+		for(const Event &event : recorded)
+			if(event.category == category)
+				slowest.push_back(&event);
+		size_t count = min(SLOWEST_COUNT, slowest.size());
+		partial_sort(slowest.begin(), slowest.begin() + count, slowest.end(),
+			[](const Event *a, const Event *b) -> bool { return a->duration > b->duration; });
+		cout << "slowest " << category << '\t' << "thread" << '\t' << "time (ms)" << '\n';
+		for(size_t i = 0; i < count; ++i)
+			cout << slowest[i]->name << '\t' << ThreadName(slowest[i]->thread) << '\t'
+				<< Milliseconds(slowest[i]->duration) << '\n';
+	}
+	cout.flush();
+}
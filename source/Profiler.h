@@ -0,0 +1,71 @@
+/* Profiler.h
+Copyright (c) 2021 by Michael Zahniser
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#ifndef PROFILER_H_
+#define PROFILER_H_
+
+#include <cstdint>
+#include <string>
+
+
+
+// Class for recording how long each part of the game's startup takes, and on
+// which thread. Each part is recorded as a span of time, which belongs to a
+// category (like "parse" for parsing data files) and optionally to a group
+// (like the plugin a data file belongs to). The result is written in the
+// Chrome trace event format, which can be viewed in chrome://tracing or in
+// Perfetto, and a summary of it is printed to STDOUT. Nothing is recorded
+// unless the profiler has been enabled.
+class Profiler {
+public:
+	// Record the time from when this object is constructed until it is
+	// destroyed. This may be used from any thread.
+	class Span {
+	public:
+		explicit Span(const std::string &name, const std::string &category = "phase", const std::string &group = "");
+		Span(const Span &) = delete;
+		~Span();
+		
+		Span &operator=(const Span &) = delete;
+		
+		// End this span and begin a new one with the given name, in the same
+		// category and group. This is convenient for timing a series of steps.
+		void Next(const std::string &name);
+		// Record that this span processed the given number of bytes, so that
+		// the throughput of its category can be reported.
+		void AddBytes(int64_t bytes);
+		
+	private:
+		void Record();
+		
+	private:
+		bool isRecording;
+		std::string name;
+		std::string category;
+		std::string group;
+		int64_t start;
+		int64_t bytes;
+	};
+	
+	
+public:
+	// Begin recording. Times are measured from when this is called.
+	static void Enable();
+	static bool IsEnabled();
+	// Stop recording, write everything recorded so far to the given path, and
+	// print a summary of it.
+	static void Finish(const std::string &path);
+};
+
+
+
+#endif
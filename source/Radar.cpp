@@ -13,9 +13,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "Radar.h"
 
 #include "GameData.h"
-#include "LineShader.h"
-#include "PointerShader.h"
-#include "RingShader.h"
+#include "PrimitiveDrawList.h"
 
 #include <cmath>
 
@@ -83,6 +81,8 @@ void Radar::AddViewportBoundary(const Point &vertex)
 // Draw the radar display at the given coordinates.
 void Radar::Draw(const Point &center, double scale, double radius, double pointerRadius) const
 {
+	PrimitiveDrawList shapes;
+	
 	// Draw any desired line vectors.
 	for(const Line &line : lines)
 	{
@@ -104,11 +104,10 @@ void Radar::Draw(const Point &center, double scale, double radius, double pointe
 		else if(endExcess > 0)
 			v -= endExcess * v.Unit();
 		
-		LineShader::Draw(start + center, start + v + center, 1.f, line.color);
+		shapes.AddLine(start + center, start + v + center, 1.f, line.color);
 	}
 	
 	// Draw StellarObjects and ships.
-	RingShader::Bind();
 	for(const Object &object : objects)
 	{
 		Point position = object.position * scale;
@@ -117,15 +116,15 @@ void Radar::Draw(const Point &center, double scale, double radius, double pointe
 			position *= radius / length;
 		position += center;
 		
-		RingShader::Add(position, object.outer, object.inner, object.color);
+		shapes.AddRing(position, object.outer, object.inner, object.color);
 	}
-	RingShader::Unbind();
 	
 	// Draw neighboring system indicators.
-	PointerShader::Bind();
 	for(const Pointer &pointer : pointers)
-		PointerShader::Add(center, pointer.unit, 10.f, 10.f, pointerRadius, pointer.color);
-	PointerShader::Unbind();
+		shapes.AddPointer(center, pointer.unit, 10.f, 10.f, pointerRadius, pointer.color);
+	
+	// All of these are drawn with a single command.
+	shapes.Draw();
 }
 
 
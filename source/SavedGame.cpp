@@ -12,16 +12,78 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 
 #include "SavedGame.h"
 
+#include "Compression.h"
 #include "DataFile.h"
 #include "DataNode.h"
 #include "Date.h"
+#include "File.h"
 #include "text/FontUtilities.h"
 #include "text/Format.h"
 #include "Languages.h"
 #include "SpriteSet.h"
 
+#include <cstdio>
+#include <sstream>
+
 using namespace std;
 
+namespace {
+	// Saved games begin with a summary of what the load panel displays, which
+	// is always within this many bytes of the start of the file.
+	const size_t HEADER_SIZE = 4096;
+	
+	// Cut the given text from the start of a saved game off after the end of
+	// its summary. If no summary is found, return an empty string.
+	string FindSummary(string &header, bool isWholeFile)
+	{
+		size_t pos = header.find("\nsummary");
+		if(pos == string::npos || pos + 8 >= header.size() || (header[pos + 8] != '\n' && header[pos + 8] != '\r'))
+			return string();
+		
+		// The summary ends at the next line that is not indented, or at the end
+		// of the file if all of it was read.
+		for(pos = header.find('\n', pos + 1); pos != string::npos; pos = header.find('\n', pos + 1))
+			if(pos + 1 < header.size() && header[pos + 1] != '\t' && header[pos + 1] != ' ')
+			{
+				header.resize(pos + 1);
+				return header;
+			}
+		return (isWholeFile ? header : string());
+	}
+	
+	// Read the beginning of the given saved game, up through the end of its
+	// summary. If no summary is found there, return an empty string.
+	string ReadHeader(const string &path)
+	{
+		File file(path);
+		if(!file)
+			return string();
+		
+		string header(HEADER_SIZE, '\0');
+		header.resize(fread(&header[0], 1, header.size(), file));
+		size_t chunkSize = Compression::FirstChunkSize(header.data(), header.size());
+		if(!chunkSize)
+			return FindSummary(header, header.size() < HEADER_SIZE);
+		
+		// A compressed file is made of chunks that can each be decompressed on
+		// their own, so only the first one needs to be read to find the summary.
+		string data = move(header);
+		size_t start = data.size();
+		if(chunkSize > start)
+		{
+			data.resize(chunkSize);
+			if(fread(&data[start], 1, chunkSize - start, file) != chunkSize - start)
+				return string();
+		}
+		bool isWholeFile = (data.size() == chunkSize && fgetc(file) == EOF);
+		
+		header.clear();
+		if(!Compression::DecompressFile(data.data(), chunkSize, header))
+			return string();
+		return FindSummary(header, isWholeFile);
+	}
+}
+
 
 
 SavedGame::SavedGame(const string &path)
@@ -34,7 +96,17 @@ SavedGame::SavedGame(const string &path)
 void SavedGame::Load(const string &path)
 {
 	Clear();
-	DataFile file(path);
+	// Only the beginning of the file needs to be parsed, unless it was saved
+	// before summaries were added.
+	DataFile file;
+	string header = ReadHeader(path);
+	if(header.empty())
+		file.Load(path);
+	else
+	{
+		istringstream in(header);
+		file.Load(in);
+	}
 	if(file.begin() != file.end())
 		this->path = path;
 	
@@ -53,6 +125,21 @@ void SavedGame::Load(const string &path)
 			planet = node.Token(1);
 		else if(node.Token(0) == "playtime" && node.Size() >= 2)
 			playTime = Format::PlayTime(node.Value(1));
+		else if(node.Token(0) == "summary")
+		{
+			for(const DataNode &child : node)
+			{
+				if(child.Token(0) == "credits" && child.Size() >= 2)
+					credits = Format::Credits(child.Value(1));
+				else if(child.Token(0) == "ship" && child.Size() >= 3)
+				{
+					shipName = FontUtilities::Escape(child.Token(1));
+					shipSprite = child.Token(2);
+				}
+			}
+			// Nothing after the summary is needed.
+			break;
+		}
 		else if(node.Token(0) == "account")
 		{
 			for(const DataNode &child : node)
@@ -62,7 +149,7 @@ void SavedGame::Load(const string &path)
 					break;
 				}
 		}
-		else if(node.Token(0) == "ship" && !shipSprite)
+		else if(node.Token(0) == "ship" && shipSprite.empty())
 		{
 			for(const DataNode &child : node)
 			{
@@ -71,7 +158,7 @@ void SavedGame::Load(const string &path)
 					// because it's saved as raw text to keep compatibility.
 					shipName = FontUtilities::Escape(child.Token(1));
 				else if(child.Token(0) == "sprite" && child.Size() >= 2)
-					shipSprite = SpriteSet::Get(child.Token(1));
+					shipSprite = child.Token(1);
 			}
 		}
 	}
@@ -105,7 +192,7 @@ void SavedGame::Clear()
 	planet.clear();
 	playTime = "0s";
 	
-	shipSprite = nullptr;
+	shipSprite.clear();
 	shipName.clear();
 }
 
@@ -155,7 +242,7 @@ const string &SavedGame::GetPlayTime() const
 
 const Sprite *SavedGame::ShipSprite() const
 {
-	return shipSprite;
+	return shipSprite.empty() ? nullptr : SpriteSet::Get(shipSprite);
 }
 
 
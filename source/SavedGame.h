@@ -25,7 +25,9 @@ class Sprite;
 // information necessary from the file to display it in the "Load Game" panel,
 // without doing all the complicated parsing that PlayerInfo does. This is so
 // that we only need to have one PlayerInfo instance, and there does not need
-// to be logic for copying one PlayerInfo into another.
+// to be logic for copying one PlayerInfo into another. Saved games begin with a
+// summary of everything shown there, so only that part of the file is parsed.
+// Saved games may be read in any thread.
 class SavedGame {
 public:
 	SavedGame() = default;
@@ -59,7 +61,9 @@ private:
 	std::string planet;
 	std::string playTime;
 	
-	const Sprite *shipSprite = nullptr;
+	// Sprites may only be looked up in the main thread, so only the name of
+	// this one is stored.
+	std::string shipSprite;
 	std::string shipName;
 };
 
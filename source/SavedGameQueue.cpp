@@ -0,0 +1,188 @@
+/* SavedGameQueue.cpp
+Copyright (c) 2021 by Michael Zahniser
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "SavedGameQueue.h"
+
+#include "Files.h"
+#include "WriteQueue.h"
+
+#include <algorithm>
+
+using namespace std;
+
+
+
+// Constructor, which starts the worker thread.
+SavedGameQueue::SavedGameQueue()
+{
+	worker = thread(ref(*this));
+}
+
+
+
+// Destructor, which waits for the worker thread to wrap up.
+SavedGameQueue::~SavedGameQueue()
+{
+	{
+		lock_guard<mutex> lock(queueMutex);
+		isDone = true;
+	}
+	condition.notify_all();
+	worker.join();
+}
+
+
+
+// Begin listing the saved games again, discarding any previous results.
+void SavedGameQueue::List()
+{
+	{
+		lock_guard<mutex> lock(queueMutex);
+		++generation;
+		shouldList = true;
+		unlisted.clear();
+		listed.clear();
+		// Any of the files may have changed, so their summaries must be read
+		// again, too.
+		previews.clear();
+	}
+	condition.notify_all();
+}
+
+
+
+// Add any pilots that have been listed since this was last called to the
+// given list. Returns false if there were none.
+bool SavedGameQueue::TakePilots(FileList &files)
+{
+	lock_guard<mutex> lock(queueMutex);
+	if(listed.empty())
+		return false;
+	
+	for(auto &it : listed)
+		files[it.first] = move(it.second);
+	listed.clear();
+	return true;
+}
+
+
+
+// Read the summaries of the given saved games, in order, replacing any
+// that were requested before but have not been read yet.
+void SavedGameQueue::Preview(const vector<string> &fileNames)
+{
+	{
+		lock_guard<mutex> lock(queueMutex);
+		toPreview.assign(fileNames.begin(), fileNames.end());
+	}
+	condition.notify_all();
+}
+
+
+
+// Get the summary of the given saved game. Returns false if it has not
+// been read yet.
+bool SavedGameQueue::Get(const string &fileName, SavedGame &savedGame)
+{
+	lock_guard<mutex> lock(queueMutex);
+	auto it = previews.find(fileName);
+	if(it == previews.end())
+		return false;
+	
+	savedGame = it->second;
+	return true;
+}
+
+
+
+// Thread entry point.
+void SavedGameQueue::operator()()
+{
+	unique_lock<mutex> lock(queueMutex);
+	while(true)
+	{
+		condition.wait(lock, [this]() -> bool
+			{ return isDone || shouldList || !toPreview.empty() || !unlisted.empty(); });
+		if(isDone)
+			return;
+		
+		// Anything read while the lock is released is discarded if the list is
+		// started over in the meantime.
+		int current = generation;
+		// Summaries come first, because the player is waiting to see them.
+		if(!toPreview.empty())
+		{
+			string fileName = move(toPreview.front());
+			toPreview.pop_front();
+			if(previews.count(fileName))
+				continue;
+			
+			lock.unlock();
+			SavedGame savedGame(Files::Saves() + fileName);
+			lock.lock();
+			if(current == generation)
+				previews[fileName] = move(savedGame);
+		}
+		else if(shouldList)
+		{
+			shouldList = false;
+			lock.unlock();
+			// Saved games are written in the background, so make sure any that
+			// are still being written are done before listing them.
+			WriteQueue::Finish();
+			map<string, vector<string>> found;
+			for(const string &path : Files::List(Files::Saves()))
+			{
+				string fileName = Files::Name(path);
+				// Skip any files that are not saved games, such as a partly written
+				// save that was left behind if the game quit while writing it.
+				if(fileName.length() < 4 || fileName.compare(fileName.length() - 4, 4, ".txt"))
+					continue;
+				// The file name is either "Pilot Name.txt" or "Pilot Name~SnapshotTitle.txt".
+				size_t pos = fileName.find('~');
+				if(pos == string::npos)
+					pos = fileName.size() - 4;
+				
+				found[fileName.substr(0, pos)].push_back(fileName);
+			}
+			lock.lock();
+			if(current == generation)
+				unlisted = move(found);
+		}
+		else
+		{
+			// Checking when each file was modified is the slow part, so it is
+			// done for one pilot at a time.
+			string pilot = unlisted.begin()->first;
+			vector<string> fileNames = move(unlisted.begin()->second);
+			unlisted.erase(unlisted.begin());
+			lock.unlock();
+			
+			vector<pair<string, time_t>> files;
+			for(string &fileName : fileNames)
+			{
+				time_t timestamp = Files::Timestamp(Files::Saves() + fileName);
+				files.emplace_back(move(fileName), timestamp);
+			}
+			sort(files.begin(), files.end(),
+				[](const pair<string, time_t> &a, const pair<string, time_t> &b) -> bool
+				{
+					return a.second > b.second;
+				}
+			);
+			
+			lock.lock();
+			if(current == generation)
+				listed[pilot] = move(files);
+		}
+	}
+}
@@ -0,0 +1,91 @@
+/* SavedGameQueue.h
+Copyright (c) 2021 by Michael Zahniser
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#ifndef SAVED_GAME_QUEUE_H_
+#define SAVED_GAME_QUEUE_H_
+
+#include "SavedGame.h"
+
+#include <condition_variable>
+#include <ctime>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+
+
+// Class for listing the saved games and reading their summaries in a worker
+// thread, so that the load panel does not have to wait for the disk. The list
+// is handed over one pilot at a time as each pilot's saved games are found,
+// and summaries are read in between, so the selected one is never stuck
+// waiting behind the whole list.
+class SavedGameQueue {
+public:
+	// The saved games of each pilot, from newest to oldest, with the time
+	// each one was last modified.
+	using FileList = std::map<std::string, std::vector<std::pair<std::string, std::time_t>>>;
+	
+	
+public:
+	SavedGameQueue();
+	~SavedGameQueue();
+	
+	// No moving or copying this class.
+	SavedGameQueue(const SavedGameQueue &other) = delete;
+	SavedGameQueue(SavedGameQueue &&other) = delete;
+	SavedGameQueue &operator=(const SavedGameQueue &other) = delete;
+	SavedGameQueue &operator=(SavedGameQueue &&other) = delete;
+	
+	// Begin listing the saved games again, discarding any previous results.
+	void List();
+	// Add any pilots that have been listed since this was last called to the
+	// given list. Returns false if there were none.
+	bool TakePilots(FileList &files);
+	
+	// Read the summaries of the given saved games, in order, replacing any
+	// that were requested before but have not been read yet.
+	void Preview(const std::vector<std::string> &fileNames);
+	// Get the summary of the given saved game. Returns false if it has not
+	// been read yet.
+	bool Get(const std::string &fileName, SavedGame &savedGame);
+	
+	// Thread entry point.
+	void operator()();
+	
+	
+private:
+	std::mutex queueMutex;
+	std::condition_variable condition;
+	bool isDone = false;
+	// This changes whenever the list is started over, so that the worker can
+	// tell whether what it just read is out of date.
+	int generation = 0;
+	
+	bool shouldList = false;
+	// Pilots whose saved games have been found but not yet sorted:
+	std::map<std::string, std::vector<std::string>> unlisted;
+	// Pilots whose saved games are sorted and ready to hand over:
+	FileList listed;
+	
+	std::deque<std::string> toPreview;
+	std::map<std::string, SavedGame> previews;
+	
+	std::thread worker;
+};
+
+
+
+#endif
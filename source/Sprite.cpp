@@ -12,6 +12,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 
 #include "Sprite.h"
 
+#include "GameData.h"
 #include "ImageBuffer.h"
 #include "Preferences.h"
 #include "Screen.h"
@@ -20,13 +21,14 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include <SDL2/SDL.h>
 
 #include <algorithm>
+#include <cstring>
 
 using namespace std;
 
 
 
 Sprite::Sprite(const string &name)
-	: name(name)
+	: name(name), isUsed(false)
 {
 }
 
@@ -39,45 +41,96 @@ const string &Sprite::Name() const
 
 
 
-// Upload the given frames. The given buffer will be cleared afterwards.
-void Sprite::AddFrames(ImageBuffer &buffer, bool is2x)
+// Upload the given frames, or as much of them as fits in the given budget of
+// bytes, which is reduced by the amount uploaded. If the budget is not zero,
+// at least some rows of one frame are uploaded even if they exceed it. This
+// must be called again with the same buffer until it returns true, at which
+// point the frames are all uploaded and the buffers will be cleared. If large
+// graphics should be reduced, the reduced buffer holds the frames shrunk to
+// half size; if they were not cached, they are shrunk into it first.
+bool Sprite::AddFrames(ImageBuffer &buffer, bool is2x, ImageBuffer &reduced, size_t &budget)
 {
 	// Do nothing if the buffer is empty.
 	if(!buffer.Pixels())
-		return;
+		return true;
+	if(!budget)
+		return false;
 	
-	// If this is the 1x image, its dimensions determine the sprite's size.
-	if(!is2x)
+	// Check whether this sprite is large enough to require size reduction.
+	// That is decided when the texture is allocated, so every part of it is
+	// uploaded from the same buffer even if the preference changes meanwhile.
+	if(!upload[is2x])
+		uploadIsReduced[is2x] = Preferences::Has("Reduce large graphics") && IsLarge(buffer);
+	const ImageBuffer *source = &buffer;
+	if(uploadIsReduced[is2x])
 	{
-		width = buffer.Width();
-		height = buffer.Height();
-		frames = buffer.Frames();
+		if(!reduced.Pixels())
+			buffer.ShrinkToHalfSize(reduced);
+		source = &reduced;
 	}
 	
-	// Check whether this sprite is large enough to require size reduction.
-	if(Preferences::Has("Reduce large graphics") && buffer.Width() * buffer.Height() >= 1000000)
-		buffer.ShrinkToHalfSize();
-	
-	// Upload the images as a single array texture.
-	glGenTextures(1, &texture[is2x]);
-	glBindTexture(GL_TEXTURE_2D_ARRAY, texture[is2x]);
-	
-	// Use linear interpolation and no wrapping.
-	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	int sourceWidth = source->Width();
+	int sourceHeight = source->Height();
+	if(!upload[is2x])
+	{
+		// If this is the 1x image, its dimensions determine the sprite's size.
+		if(!is2x)
+		{
+			width = buffer.Width();
+			height = buffer.Height();
+			frames = buffer.Frames();
+		}
+		
+		// Upload the images as a single array texture, which is allocated
+		// now but not used until all of its frames have been uploaded.
+		glGenTextures(1, &upload[is2x]);
+		glBindTexture(GL_TEXTURE_2D_ARRAY, upload[is2x]);
+		
+		// Use linear interpolation and no wrapping.
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		
+		glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, // target, mipmap level, internal format,
+			sourceWidth, sourceHeight, source->Frames(), // width, height, depth,
+			0, GL_BGRA, GL_UNSIGNED_BYTE, nullptr); // border, input format, data type, data.
+		uploadedRows[is2x] = 0;
+	}
+	else
+		glBindTexture(GL_TEXTURE_2D_ARRAY, upload[is2x]);
 	
-	// Upload the image data.
-	glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, // target, mipmap level, internal format,
-		buffer.Width(), buffer.Height(), buffer.Frames(), // width, height, depth,
-		0, GL_BGRA, GL_UNSIGNED_BYTE, buffer.Pixels()); // border, input format, data type, data.
+	// Upload the image data in bands of rows, each of which is within a single
+	// frame, until the budget runs out.
+	size_t rowBytes = 4 * static_cast<size_t>(sourceWidth);
+	int totalRows = sourceHeight * source->Frames();
+	while(budget && uploadedRows[is2x] < totalRows)
+	{
+		int frame = uploadedRows[is2x] / sourceHeight;
+		int y = uploadedRows[is2x] % sourceHeight;
+		int rows = max<int>(1, min<size_t>(budget / rowBytes, sourceHeight - y));
+		UploadRows(source->Begin(y, frame), sourceWidth, y, rows, frame);
+		uploadedRows[is2x] += rows;
+		budget -= min(budget, rows * rowBytes);
+	}
 	
 	// Unbind the texture.
 	glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+	if(uploadedRows[is2x] < totalRows)
+		return false;
+	
+	// Now that every frame is uploaded, the texture can be drawn. A sprite
+	// that was unloaded partway through being uploaded may still have one of
+	// its textures, so replace it if it does.
+	glDeleteTextures(1, &texture[is2x]);
+	textureMemory[is2x] = rowBytes * totalRows;
+	texture[is2x] = upload[is2x];
+	upload[is2x] = 0;
 	
 	// Free the ImageBuffer memory.
 	buffer.Clear();
+	reduced.Clear();
+	return true;
 }
 
 
@@ -92,16 +145,38 @@ void Sprite::AddMasks(vector<Mask> &masks)
 
 
 
-// Free up all textures loaded for this sprite.
+// Make this a sprite whose frames are only loaded once it is drawn, and
+// whose textures may be unloaded again if it is not drawn for a while.
+// Its dimensions must be known without loading it.
+void Sprite::Defer(int width, int height, int frames)
+{
+	this->width = width;
+	this->height = height;
+	this->frames = frames;
+	isDeferred = true;
+}
+
+
+
+// Free up all textures loaded for this sprite. Its dimensions and masks
+// are kept, so it can still be used by the game until it is reloaded.
 void Sprite::Unload()
 {
+	// If this sprite is still being uploaded, the upload will start over.
 	glDeleteTextures(2, texture);
+	glDeleteTextures(2, upload);
 	texture[0] = texture[1] = 0;
-	
-	masks.clear();
-	width = 0.f;
-	height = 0.f;
-	frames = 0;
+	upload[0] = upload[1] = 0;
+	textureMemory[0] = textureMemory[1] = 0;
+}
+
+
+
+// Check whether the given frames are large enough that they are reduced to
+// half size when the "Reduce large graphics" preference is set.
+bool Sprite::IsLarge(const ImageBuffer &buffer)
+{
+	return (buffer.Width() * buffer.Height() >= 1000000);
 }
 
 
@@ -150,11 +225,34 @@ uint32_t Sprite::Texture() const
 // Get the index of the texture for the given high DPI mode.
 uint32_t Sprite::Texture(bool isHighDPI) const
 {
+	if(isDeferred)
+	{
+		isUsed = true;
+		if(!texture[0])
+			GameData::Preload(this);
+	}
 	return (isHighDPI && texture[1]) ? texture[1] : texture[0];
 }
 
 
 
+// Get the amount of texture memory this sprite is using, in bytes.
+size_t Sprite::TextureMemory() const
+{
+	return textureMemory[0] + textureMemory[1];
+}
+
+
+
+// Check whether the texture of a deferred sprite has been asked for since
+// the last time this was called.
+bool Sprite::WasUsed() const
+{
+	return isUsed.exchange(false);
+}
+
+
+
 // Get the collision mask for the given frame of the animation.
 const Mask &Sprite::GetMask(int frame) const
 {
@@ -165,3 +263,39 @@ const Mask &Sprite::GetMask(int frame) const
 	// Assume that if a masks array exists, it has the right number of frames.
 	return masks[frame % masks.size()];
 }
+
+
+
+// Copy the given rows of one frame to the texture that is being uploaded,
+// which must be bound. The rows are streamed through a pixel buffer object, so
+// that OpenGL can copy them to the texture asynchronously instead of the
+// main thread waiting while it does.
+void Sprite::UploadRows(const uint32_t *data, int width, int y, int rows, int frame)
+{
+	static GLuint pixelBuffer = 0;
+	if(!pixelBuffer)
+		glGenBuffers(1, &pixelBuffer);
+	
+	size_t size = 4 * static_cast<size_t>(width) * rows;
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pixelBuffer);
+	// Replace the buffer's storage rather than reusing it, so that this does
+	// not have to wait for the previous upload from it to finish.
+	glBufferData(GL_PIXEL_UNPACK_BUFFER, size, nullptr, GL_STREAM_DRAW);
+	void *mapped = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+	if(mapped)
+	{
+		memcpy(mapped, data, size);
+		if(glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER))
+		{
+			glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, y, frame, width, rows, 1,
+				GL_BGRA, GL_UNSIGNED_BYTE, nullptr);
+			glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+			return;
+		}
+	}
+	
+	// If the buffer could not be mapped, upload the rows directly instead.
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+	glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, y, frame, width, rows, 1,
+		GL_BGRA, GL_UNSIGNED_BYTE, data);
+}
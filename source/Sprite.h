@@ -16,6 +16,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "Mask.h"
 #include "Point.h"
 
+#include <atomic>
 #include <cstdint>
 #include <string>
 #include <vector>
@@ -36,14 +37,29 @@ public:
 	
 	const std::string &Name() const;
 	
-	// Upload the given frames. The given buffer will be cleared afterwards.
-	void AddFrames(ImageBuffer &buffer, bool is2x);
+	// Upload the given frames, or as much of them as fits in the given budget of
+	// bytes, which is reduced by the amount uploaded. If the budget is not zero,
+	// at least some rows of one frame are uploaded even if they exceed it. This
+	// must be called again with the same buffer until it returns true, at which
+	// point the frames are all uploaded and the buffers will be cleared. If large
+	// graphics should be reduced, the reduced buffer holds the frames shrunk to
+	// half size; if they were not cached, they are shrunk into it first.
+	bool AddFrames(ImageBuffer &buffer, bool is2x, ImageBuffer &reduced, size_t &budget);
 	// Move the given masks into this sprite's internal storage. The given
 	// vector will be cleared.
 	void AddMasks(std::vector<Mask> &masks);
-	// Free up all textures loaded for this sprite.
+	// Make this a sprite whose frames are only loaded once it is drawn, and
+	// whose textures may be unloaded again if it is not drawn for a while.
+	// Its dimensions must be known without loading it.
+	void Defer(int width, int height, int frames);
+	// Free up all textures loaded for this sprite. Its dimensions and masks
+	// are kept, so it can still be used by the game until it is reloaded.
 	void Unload();
 	
+	// Check whether the given frames are large enough that they are reduced to
+	// half size when the "Reduce large graphics" preference is set.
+	static bool IsLarge(const ImageBuffer &buffer);
+	
 	// Image dimensions, in pixels.
 	float Width() const;
 	float Height() const;
@@ -56,19 +72,43 @@ public:
 	Point Center() const;
 	
 	// Get the texture index, either looking it up based on the Screen's HighDPI
-	// setting or specifying it manually.
+	// setting or specifying it manually. If this sprite is deferred and is not
+	// loaded, this begins loading it, and the texture will be 0 until it is.
+	// Anything drawn with texture 0 would be an opaque black rectangle, so
+	// the shaders draw nothing at all for a sprite whose texture is 0.
 	uint32_t Texture() const;
 	uint32_t Texture(bool isHighDPI) const;
+	// Get the amount of texture memory this sprite is using, in bytes.
+	size_t TextureMemory() const;
+	// Check whether the texture of a deferred sprite has been asked for since
+	// the last time this was called.
+	bool WasUsed() const;
 	// Get the collision mask for the given frame of the animation.
 	const Mask &GetMask(int frame = 0) const;
 	
 	
+private:
+	// Copy the given rows of one frame to the texture that is being uploaded,
+	// which must be bound.
+	static void UploadRows(const uint32_t *data, int width, int y, int rows, int frame);
+	
+	
 private:
 	std::string name;
 	
 	uint32_t texture[2] = {0, 0};
+	// Textures that are still being uploaded, whether they are being uploaded
+	// at half size, and how many rows of all their frames have been uploaded
+	// so far:
+	uint32_t upload[2] = {0, 0};
+	bool uploadIsReduced[2] = {false, false};
+	int uploadedRows[2] = {0, 0};
+	size_t textureMemory[2] = {0, 0};
 	std::vector<Mask> masks;
 	
+	bool isDeferred = false;
+	mutable std::atomic<bool> isUsed;
+	
 	float width = 0.f;
 	float height = 0.f;
 	int frames = 0;
@@ -15,14 +15,23 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "ImageBuffer.h"
 #include "ImageSet.h"
 #include "Mask.h"
+#include "Profiler.h"
 #include "Sprite.h"
 #include "SpriteSet.h"
 
 #include <algorithm>
 #include <functional>
+#include <limits>
 
 using namespace std;
 
+namespace {
+	// Each time the progress is checked, which normally happens once per
+	// frame, at most this many bytes of image data are uploaded to the GPU,
+	// so that uploading a lot of sprites does not stall the game.
+	const size_t UPLOAD_BUDGET = 16 << 20;
+}
+
 
 
 // Constructor, which allocates worker threads.
@@ -58,7 +67,7 @@ void SpriteQueue::Add(const shared_ptr<ImageSet> &images)
 		if(added < 0)
 			return;
 		
-		toRead.push(images);
+		toRead.push_back(Task{images, -1});
 		++added;
 	}
 	readCondition.notify_one();
@@ -79,12 +88,12 @@ void SpriteQueue::Unload(const string &name)
 double SpriteQueue::Progress()
 {
 	unique_lock<mutex> lock(loadMutex);
-	return DoLoad(lock);
+	return DoLoad(lock, UPLOAD_BUDGET);
 }
 
 
 
-// Finish loading.
+// Finish loading, uploading everything that remains at once.
 void SpriteQueue::Finish()
 {
 	// Loop until done loading.
@@ -93,7 +102,7 @@ void SpriteQueue::Finish()
 		unique_lock<mutex> lock(loadMutex);
 		
 		// Load whatever is already queued up for loading.
-		if(DoLoad(lock) == 1.)
+		if(DoLoad(lock, numeric_limits<size_t>::max()) == 1.)
 			break;
 		
 		// We still have sprites to upload, but none of them have been read from
@@ -120,23 +129,61 @@ void SpriteQueue::operator()()
 				break;
 			
 			// Extract the one item we should work on reading right now.
-			shared_ptr<ImageSet> imageSet = toRead.front();
-			toRead.pop();
+			Task task = toRead.front();
+			toRead.pop_front();
 			
 			// It's now safe to add to the lists.
 			lock.unlock();
 			
-			// Load the sprite.
-			imageSet->Load();
-			
+			// The first task for each sprite determines how many frames it has
+			// that need to be read. Each frame is then read as a separate task,
+			// so that sprites with many frames are split among all the threads.
+			size_t frames = 0;
+			if(task.frame < 0)
+			{
+				Profiler::Span span(task.images->Name(), "prepare");
+				frames = task.images->Prepare();
+			}
+			else
 			{
-				// The texture must be uploaded to OpenGL in the main thread.
-				unique_lock<mutex> lock(loadMutex);
-				toLoad.push(imageSet);
+				Profiler::Span span(task.images->Name(), "decode");
+				task.images->LoadFrame(task.frame);
 			}
-			loadCondition.notify_one();
 			
 			lock.lock();
+			bool isDone = false;
+			if(task.frame >= 0)
+			{
+				auto it = remaining.find(task.images.get());
+				isDone = !--it->second;
+				if(isDone)
+					remaining.erase(it);
+			}
+			else if(frames)
+			{
+				// Put the frames at the front of the queue, so that each sprite
+				// is finished as soon as possible once it has been started.
+				remaining[task.images.get()] = frames;
+				for(size_t i = frames; i--; )
+					toRead.push_front(Task{task.images, static_cast<int>(i)});
+				readCondition.notify_all();
+			}
+			else
+				isDone = true;
+			
+			if(isDone)
+			{
+				lock.unlock();
+				if(task.frame >= 0)
+					task.images->Finish();
+				{
+					// The texture must be uploaded to OpenGL in the main thread.
+					unique_lock<mutex> lock(loadMutex);
+					toLoad.push(task.images);
+				}
+				loadCondition.notify_one();
+				lock.lock();
+			}
 		}
 		
 		readCondition.wait(lock);
@@ -145,7 +192,7 @@ void SpriteQueue::operator()()
 
 
 
-double SpriteQueue::DoLoad(unique_lock<mutex> &lock)
+double SpriteQueue::DoLoad(unique_lock<mutex> &lock, size_t budget)
 {
 	while(!toUnload.empty())
 	{
@@ -157,19 +204,32 @@ double SpriteQueue::DoLoad(unique_lock<mutex> &lock)
 		lock.lock();
 	}
 	
-	for(int i = 0; !toLoad.empty() && i < 100; ++i)
+	// Upload sprites until the budget is used up. A sprite that does not fit
+	// in the budget is left at the front of the queue, and the rest of it is
+	// uploaded the next time this is called. Only this thread takes sprites
+	// out of the queue, so it stays at the front until it is done.
+	while(!toLoad.empty() && budget)
 	{
 		// Extract the one item we should work on uploading right now.
 		shared_ptr<ImageSet> imageSet = toLoad.front();
-		toLoad.pop();
 		
 		// It's now safe to modify the lists.
 		lock.unlock();
 		
-		imageSet->Upload(SpriteSet::Modify(imageSet->Name()));
+		bool isDone = false;
+		{
+			Profiler::Span span(imageSet->Name(), "upload");
+			size_t before = budget;
+			isDone = imageSet->Upload(SpriteSet::Modify(imageSet->Name()), budget);
+			span.AddBytes(before - budget);
+		}
 		
 		lock.lock();
-		++completed;
+		if(isDone)
+		{
+			toLoad.pop();
+			++completed;
+		}
 	}
 	
 	// Wait until we have completed loading of as many sprites as we have added.
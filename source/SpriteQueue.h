@@ -14,6 +14,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #define SPRITE_QUEUE_H_
 
 #include <condition_variable>
+#include <deque>
 #include <map>
 #include <memory>
 #include <mutex>
@@ -46,10 +47,11 @@ public:
 	void Add(const std::shared_ptr<ImageSet> &images);
 	// Unload the texture for the given sprite (to free up memory).
 	void Unload(const std::string &name);
-	// Upload more images and find out our percent completion.
+	// Upload more images, up to a limited number of bytes each time this is
+	// called, and find out our percent completion.
 	// TODO: make this a const accessor.
 	double Progress();
-	// Finish loading.
+	// Finish loading, uploading everything that remains at once.
 	void Finish();
 	
 	// Thread entry point.
@@ -57,15 +59,27 @@ public:
 	
 	
 private:
-	double DoLoad(std::unique_lock<std::mutex> &lock);
+	double DoLoad(std::unique_lock<std::mutex> &lock, size_t budget);
 	
 	
 private:
-	// These are the image sets that need to be loaded from disk.
-	std::queue<std::shared_ptr<ImageSet>> toRead;
+	// A task for one of the worker threads: either preparing to load an image
+	// set (if the frame is negative), or reading one of its frames.
+	class Task {
+	public:
+		std::shared_ptr<ImageSet> images;
+		int frame;
+	};
+	
+	
+private:
+	// These are the image sets and frames that need to be loaded from disk.
+	std::deque<Task> toRead;
 	std::mutex readMutex;
 	std::condition_variable readCondition;
 	int added = 0;
+	// How many frames of each image set are still being read.
+	std::map<const ImageSet *, size_t> remaining;
 	
 	// These image sets have been loaded from disk but have not been uplodaed.
 	std::queue<std::shared_ptr<ImageSet>> toLoad;
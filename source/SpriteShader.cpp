@@ -212,6 +212,9 @@ void SpriteShader::Draw(const Sprite *sprite, const Point &position, float zoom,
 	
 	Item item;
 	item.texture = sprite->Texture();
+	// Sprites that are still being loaded are not drawn.
+	if(!item.texture)
+		return;
 	item.frame = frame;
 	item.frameCount = sprite->Frames();
 	// Position.
@@ -243,6 +246,10 @@ void SpriteShader::Bind()
 
 void SpriteShader::Add(const Item &item, bool withBlur)
 {
+	// Texture 0 means the sprite is still being loaded.
+	if(!item.texture)
+		return;
+	
 	glBindTexture(GL_TEXTURE_2D_ARRAY, item.texture);
 
 	glUniform1f(frameI, item.frame);
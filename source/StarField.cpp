@@ -26,6 +26,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include <algorithm>
 #include <cmath>
 #include <numeric>
+#include <vector>
 
 using namespace std;
 
@@ -125,21 +126,47 @@ void StarField::Draw(const Point &pos, const Point &vel, double zoom) const
 		// Round down to the start of the nearest tile.
 		minX &= ~(TILE_SIZE - 1l);
 		minY &= ~(TILE_SIZE - 1l);
-	
-		for(int gy = minY; gy < maxY; gy += TILE_SIZE)
-			for(int gx = minX; gx < maxX; gx += TILE_SIZE)
+		
+		// The star pattern repeats every "width" pixels. Draw each repetition
+		// that is on screen with a single command, consisting of one range of
+		// stars for each row of tiles that is visible. Rows that are visible
+		// in their full width are contiguous, so they merge into one range.
+		const int width = widthMod + 1;
+		vector<GLint> first;
+		vector<GLsizei> count;
+		first.reserve(tileCols);
+		count.reserve(tileCols);
+		for(int wy = minY & ~widthMod; wy < maxY; wy += width)
+			for(int wx = minX & ~widthMod; wx < maxX; wx += width)
 			{
-				Point off = Point(gx, gy) - pos;
+				Point off = Point(wx, wy) - pos;
 				GLfloat translate[2] = {
 					static_cast<float>(off.X()),
 					static_cast<float>(off.Y())
 				};
 				glUniform2fv(translateI, 1, translate);
 				
-				int index = (gx & widthMod) / TILE_SIZE + ((gy & widthMod) / TILE_SIZE) * tileCols;
-				int first = 6 * tileIndex[index];
-				int count = 6 * tileIndex[index + 1] - first;
-				glDrawArrays(GL_TRIANGLES, first, count);
+				// Find which tiles of this repetition are visible.
+				int firstCol = (max(minX, wx) - wx) / TILE_SIZE;
+				int lastCol = (min(maxX, wx + width) - wx - 1) / TILE_SIZE;
+				int firstRow = (max(minY, wy) - wy) / TILE_SIZE;
+				int lastRow = (min(maxY, wy + width) - wy - 1) / TILE_SIZE;
+				
+				first.clear();
+				count.clear();
+				for(int row = firstRow; row <= lastRow; ++row)
+				{
+					int begin = 6 * tileIndex[firstCol + row * tileCols];
+					int end = 6 * tileIndex[lastCol + 1 + row * tileCols];
+					if(!first.empty() && first.back() + count.back() == begin)
+						count.back() += end - begin;
+					else
+					{
+						first.push_back(begin);
+						count.push_back(end - begin);
+					}
+				}
+				glMultiDrawArrays(GL_TRIANGLES, first.data(), count.data(), first.size());
 			}
 	
 		glBindVertexArray(0);
@@ -301,10 +328,12 @@ void StarField::MakeStars(int stars, int width)
 		int y = *it++;
 		int index = (x / TILE_SIZE) + (y / TILE_SIZE) * tileCols;
 		
-		// Randomize its sub-pixel position and its size / brightness.
+		// Randomize its sub-pixel position and its size / brightness. The
+		// position is relative to the whole pattern, not to the tile, so that
+		// every tile of the pattern can be drawn with the same translation.
 		int random = Random::Int(4096);
-		float fx = (x & (TILE_SIZE - 1)) + (random & 15) * 0.0625f;
-		float fy = (y & (TILE_SIZE - 1)) + (random >> 8) * 0.0625f;
+		float fx = x + (random & 15) * 0.0625f;
+		float fy = y + (random >> 8) * 0.0625f;
 		float size = (((random >> 4) & 15) + 20) * 0.0625f;
 		
 		// Fill in the data array.
@@ -23,6 +23,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "Planet.h"
 #include "Random.h"
 #include "SpriteSet.h"
+#include "SystemGrid.h"
 
 #include <algorithm>
 #include <cmath>
@@ -384,6 +385,8 @@ void System::Load(const DataNode &node, Set<Planet> &planets)
 				object.message = &UNINHABITEDPLANET.Str();
 		}
 	}
+	attributeBits = AttributeBits(attributes);
+	
 	// Print a warning if this system wasn't explicitly given a position.
 	if(!hasPosition)
 		node.PrintTrace("Warning: system will be ignored due to missing position:");
@@ -394,7 +397,7 @@ void System::Load(const DataNode &node, Set<Planet> &planets)
 // Update any information about the system that may have changed due to events,
 // or because the game was started, e.g. neighbors, solar wind and power, or
 // if the system is inhabited.
-void System::UpdateSystem(const Set<System> &systems, const set<double> &neighborDistances)
+void System::UpdateSystem(const SystemGrid &grid, const set<double> &neighborDistances)
 {
 	neighbors.clear();
 	// Neighbors are cached for each system for the purpose of quicker
@@ -404,15 +407,15 @@ void System::UpdateSystem(const Set<System> &systems, const set<double> &neighbo
 	// jump range that can be encountered.
 	if(jumpRange)
 	{
-		UpdateNeighbors(systems, jumpRange);
+		UpdateNeighbors(grid, jumpRange);
 		// Systems with a static jump range must also create a set for
 		// the DEFAULT_NEIGHBOR_DISTANCE to be returned for those systems
 		// which are visible from it.
-		UpdateNeighbors(systems, DEFAULT_NEIGHBOR_DISTANCE);
+		UpdateNeighbors(grid, DEFAULT_NEIGHBOR_DISTANCE);
 	}
 	else
 		for(const double distance : neighborDistances)
-			UpdateNeighbors(systems, distance);
+			UpdateNeighbors(grid, distance);
 	
 	// Calculate the solar power and solar wind.
 	solarPower = 0.;
@@ -429,6 +432,7 @@ void System::UpdateSystem(const Set<System> &systems, const set<double> &neighbo
 		attributes.erase("uninhabited");
 	else
 		attributes.insert("uninhabited");
+	attributeBits = AttributeBits(attributes);
 }
 
 
@@ -515,6 +519,14 @@ const set<string> &System::Attributes() const
 
 
 
+// Get the same attributes as a bitset, for location filters.
+const AttributeBits &System::GetAttributeBits() const
+{
+	return attributeBits;
+}
+
+
+
 // Get a list of systems you can travel to through hyperspace from here.
 const set<const System *> &System::Links() const
 {
@@ -858,7 +870,7 @@ void System::LoadObject(const DataNode &node, Set<Planet> &planets, int parent)
 // Once the star map is fully loaded or an event has changed systems
 // or links, figure out which stars are "neighbors" of this one, i.e.
 // close enough to see or to reach via jump drive.
-void System::UpdateNeighbors(const Set<System> &systems, double distance)
+void System::UpdateNeighbors(const SystemGrid &grid, double distance)
 {
 	set<const System *> &neighborSet = neighbors[distance];
 	
@@ -868,16 +880,10 @@ void System::UpdateNeighbors(const Set<System> &systems, double distance)
 		neighborSet.insert(system);
 	
 	// Any other star system that is within the neighbor distance is also a
-	// neighbor.
-	for(const auto &it : systems)
-	{
-		// Skip systems that have no name.
-		if(it.first.empty() || it.second.Name().empty())
-			continue;
-
-		if(&it.second != this && it.second.Position().Distance(position) <= distance)
-			neighborSet.insert(&it.second);
-	}
+	// neighbor. (The grid only contains systems that have a name.)
+	for(const System *system : grid.Within(position, distance))
+		if(system != this)
+			neighborSet.insert(system);
 }
 
 
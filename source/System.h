@@ -13,6 +13,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #ifndef SYSTEM_H_
 #define SYSTEM_H_
 
+#include "AttributeBits.h"
 #include "text/Gettext.h"
 #include "Point.h"
 #include "Set.h"
@@ -31,6 +32,7 @@ class Minable;
 class Planet;
 class Ship;
 class Sprite;
+class SystemGrid;
 
 
 
@@ -90,7 +92,7 @@ public:
 	void Load(const DataNode &node, Set<Planet> &planets);
 	// Update any information about the system that may have changed due to events,
 	// e.g. neighbors, solar wind and power, or if the system is inhabited.
-	void UpdateSystem(const Set<System> &systems, const std::set<double> &neighborDistances);
+	void UpdateSystem(const SystemGrid &grid, const std::set<double> &neighborDistances);
 	
 	// Modify a system's links.
 	void Link(System *other);
@@ -113,6 +115,8 @@ public:
 	
 	// Get the list of "attributes" of the planet.
 	const std::set<std::string> &Attributes() const;
+	// Get the same attributes as a bitset, for location filters.
+	const AttributeBits &GetAttributeBits() const;
 	
 	// Get a list of systems you can travel to through hyperspace from here.
 	const std::set<const System *> &Links() const;
@@ -183,7 +187,7 @@ private:
 	// Once the star map is fully loaded or an event has changed systems
 	// or links, figure out which stars are "neighbors" of this one, i.e.
 	// close enough to see or to reach via jump drive.
-	void UpdateNeighbors(const Set<System> &systems, double distance);
+	void UpdateNeighbors(const SystemGrid &grid, double distance);
 	
 	
 private:
@@ -247,6 +251,7 @@ private:
 	
 	// Attributes, for use in location filters.
 	std::set<std::string> attributes;
+	AttributeBits attributeBits;
 };
 
 
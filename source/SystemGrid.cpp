@@ -0,0 +1,155 @@
+/* SystemGrid.cpp
+Copyright (c) 2021 by Michael Zahniser
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "SystemGrid.h"
+
+#include "Rectangle.h"
+#include "System.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+namespace {
+	// If the systems are very spread out, make the cells larger so that the
+	// grid never has many more cells than there are systems.
+	const size_t CELLS_PER_SYSTEM = 4;
+}
+
+
+
+// Index the positions of all the systems that have a name.
+void SystemGrid::Build(const Set<System> &systems)
+{
+	this->systems.clear();
+	cellStart.clear();
+	columns = 0;
+	rows = 0;
+	
+	vector<const System *> named;
+	Point topLeft;
+	Point bottomRight;
+	for(const auto &it : systems)
+	{
+		// Skip systems that have no name.
+		if(it.first.empty() || it.second.Name().empty())
+			continue;
+		
+		const Point &pos = it.second.Position();
+		if(named.empty())
+			topLeft = bottomRight = pos;
+		topLeft = Point(min(topLeft.X(), pos.X()), min(topLeft.Y(), pos.Y()));
+		bottomRight = Point(max(bottomRight.X(), pos.X()), max(bottomRight.Y(), pos.Y()));
+		named.push_back(&it.second);
+	}
+	if(named.empty())
+		return;
+	
+	origin = topLeft;
+	Point size = bottomRight - topLeft;
+	// Start with cells the size of the default distance at which systems are
+	// visible from each other, so most lookups only need to check a few cells.
+	cellSize = System::DEFAULT_NEIGHBOR_DISTANCE;
+	while(true)
+	{
+		columns = static_cast<int>(size.X() / cellSize) + 1;
+		rows = static_cast<int>(size.Y() / cellSize) + 1;
+		if(static_cast<size_t>(columns) * rows <= CELLS_PER_SYSTEM * named.size())
+			break;
+		cellSize *= 2.;
+	}
+	
+	// Sort the systems by cell, keeping them in the same order within each
+	// cell that they have in the set.
+	auto cellOf = [this](const System *system) -> size_t
+	{
+		Point pos = (system->Position() - origin) / cellSize;
+		int x = min(columns - 1, static_cast<int>(pos.X()));
+		int y = min(rows - 1, static_cast<int>(pos.Y()));
+		return static_cast<size_t>(y) * columns + x;
+	};
+	cellStart.resize(static_cast<size_t>(columns) * rows + 1, 0);
+	for(const System *system : named)
+		++cellStart[cellOf(system) + 1];
+	for(size_t i = 1; i < cellStart.size(); ++i)
+		cellStart[i] += cellStart[i - 1];
+	
+	this->systems.resize(named.size());
+	vector<size_t> next(cellStart.begin(), cellStart.end() - 1);
+	for(const System *system : named)
+		this->systems[next[cellOf(system)]++] = system;
+}
+
+
+
+// Get all the systems that are no farther than the given distance from
+// the given point.
+vector<const System *> SystemGrid::Within(const Point &center, double radius) const
+{
+	vector<const System *> result;
+	int left, top, right, bottom;
+	if(!Cells(center - Point(radius, radius), center + Point(radius, radius), left, top, right, bottom))
+		return result;
+	
+	for(int y = top; y <= bottom; ++y)
+	{
+		size_t row = static_cast<size_t>(y) * columns;
+		for(auto it = systems.begin() + cellStart[row + left]; it != systems.begin() + cellStart[row + right + 1]; ++it)
+			if((*it)->Position().Distance(center) <= radius)
+				result.push_back(*it);
+	}
+	return result;
+}
+
+
+
+// Get all the systems whose positions are inside the given rectangle.
+vector<const System *> SystemGrid::Inside(const Rectangle &area) const
+{
+	vector<const System *> result;
+	int left, top, right, bottom;
+	if(!Cells(area.TopLeft(), area.BottomRight(), left, top, right, bottom))
+		return result;
+	
+	for(int y = top; y <= bottom; ++y)
+	{
+		size_t row = static_cast<size_t>(y) * columns;
+		for(auto it = systems.begin() + cellStart[row + left]; it != systems.begin() + cellStart[row + right + 1]; ++it)
+			if(area.Contains((*it)->Position()))
+				result.push_back(*it);
+	}
+	return result;
+}
+
+
+
+// Find the range of grid cells which overlaps the given corners. Returns
+// false if the range is entirely outside the grid.
+bool SystemGrid::Cells(const Point &topLeft, const Point &bottomRight, int &left, int &top, int &right, int &bottom) const
+{
+	if(!columns)
+		return false;
+	
+	// Clamp the corners to the grid before converting them to cell indices,
+	// in case the area is much larger than the whole map.
+	Point from = (topLeft - origin) / cellSize;
+	Point to = (bottomRight - origin) / cellSize;
+	if(to.X() < 0. || to.Y() < 0. || from.X() >= columns || from.Y() >= rows)
+		return false;
+	
+	left = static_cast<int>(max(0., from.X()));
+	top = static_cast<int>(max(0., from.Y()));
+	right = static_cast<int>(min(columns - 1., to.X()));
+	bottom = static_cast<int>(min(rows - 1., to.Y()));
+	return true;
+}
@@ -0,0 +1,63 @@
+/* SystemGrid.h
+Copyright (c) 2021 by Michael Zahniser
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#ifndef SYSTEM_GRID_H_
+#define SYSTEM_GRID_H_
+
+#include "Point.h"
+#include "Set.h"
+
+#include <vector>
+
+class Rectangle;
+class System;
+
+
+
+// A uniform grid over the positions of all the star systems on the map, so
+// finding the systems near a given point (e.g. under the mouse, or within jump
+// range) or within a given area (e.g. on the screen) does not require checking
+// every system in the galaxy. The grid must be rebuilt whenever systems are
+// created or moved.
+class SystemGrid {
+public:
+	// Index the positions of all the systems that have a name.
+	void Build(const Set<System> &systems);
+	
+	// Get all the systems that are no farther than the given distance from
+	// the given point.
+	std::vector<const System *> Within(const Point &center, double radius) const;
+	// Get all the systems whose positions are inside the given rectangle.
+	std::vector<const System *> Inside(const Rectangle &area) const;
+	
+	
+private:
+	// Find the range of grid cells which overlaps the given corners. Returns
+	// false if the range is entirely outside the grid.
+	bool Cells(const Point &topLeft, const Point &bottomRight, int &left, int &top, int &right, int &bottom) const;
+	
+	
+private:
+	// The corner of the top left cell, and the size of each cell.
+	Point origin;
+	double cellSize = 0.;
+	int columns = 0;
+	int rows = 0;
+	// The systems are sorted by cell, and each cell holds the index of its
+	// first system in that list (so each cell ends where the next one begins).
+	std::vector<size_t> cellStart;
+	std::vector<const System *> systems;
+};
+
+
+
+#endif
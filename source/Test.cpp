@@ -382,9 +382,8 @@ void Test::Fail(const Context &context, const PlayerInfo &player, const string &
 	// Future versions of the test-framework could also print all conditions that are used in the test.
 	string conditions = "";
 	const string TEST_PREFIX = "test: ";
-	auto it = player.Conditions().lower_bound(TEST_PREFIX);
-	for( ; it != player.Conditions().end() && !it->first.compare(0, TEST_PREFIX.length(), TEST_PREFIX); ++it)
-		conditions += "Condition: \"" + it->first + "\" = " + to_string(it->second) + "\n";
+	for(const auto &it : player.Conditions().List(TEST_PREFIX))
+		conditions += "Condition: \"" + it.first + "\" = " + to_string(it.second) + "\n";
 	
 	if(!conditions.empty())
 		Files::LogError(conditions);
@@ -0,0 +1,100 @@
+/* WriteQueue.cpp
+Copyright (c) 2021 by Michael Zahniser
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "WriteQueue.h"
+
+#include "Compression.h"
+#include "Files.h"
+
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <thread>
+
+using namespace std;
+
+namespace {
+	class Entry {
+	public:
+		string data;
+		bool compress;
+	};
+	
+	mutex queueMutex;
+	condition_variable writeCondition;
+	// The files that are waiting to be written, and what to write to them:
+	map<string, Entry> pending;
+	// The writer thread only runs while there is something to write.
+	thread writer;
+	bool isWriting = false;
+	
+	// Thread entry point.
+	void Write()
+	{
+		unique_lock<mutex> lock(queueMutex);
+		while(!pending.empty())
+		{
+			string path = pending.begin()->first;
+			Entry entry = move(pending.begin()->second);
+			pending.erase(pending.begin());
+			
+			// Once a file has been taken out of the list, a newer version of it
+			// can be added, which will be written after this one is done.
+			lock.unlock();
+			if(entry.compress)
+			{
+				// Compressed data must not have its newlines converted.
+				string compressed;
+				Compression::CompressFile(entry.data.data(), entry.data.size(), compressed);
+				Files::WriteBinary(path + "~", compressed);
+			}
+			else
+				Files::Write(path + "~", entry.data);
+			Files::Move(path + "~", path);
+			lock.lock();
+		}
+		isWriting = false;
+		writeCondition.notify_all();
+	}
+}
+
+
+
+// Write the given data to the given path, replacing anything that is still
+// waiting to be written there. If requested, the data is compressed first,
+// which is also done in the background.
+void WriteQueue::Add(const string &path, string data, bool compress)
+{
+	lock_guard<mutex> lock(queueMutex);
+	pending[path] = Entry{move(data), compress};
+	if(isWriting)
+		return;
+	
+	// If the writer thread ran before, it has already finished, because it
+	// only stops writing once there is nothing left to write.
+	if(writer.joinable())
+		writer.join();
+	isWriting = true;
+	writer = thread(&Write);
+}
+
+
+
+// Wait until every file that has been added is written. This must be done
+// before reading any of those files, and before the game quits.
+void WriteQueue::Finish()
+{
+	unique_lock<mutex> lock(queueMutex);
+	writeCondition.wait(lock, []() -> bool { return !isWriting; });
+	if(writer.joinable())
+		writer.join();
+}
@@ -0,0 +1,38 @@
+/* WriteQueue.h
+Copyright (c) 2021 by Michael Zahniser
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#ifndef WRITE_QUEUE_H_
+#define WRITE_QUEUE_H_
+
+#include <string>
+
+
+
+// Class for writing files, like saved games, on a background thread so that
+// the game does not pause while they are written. Each file is written to a
+// temporary file first, which then replaces it, so that a file is never left
+// partly written. If a file is added again before the previous version of it
+// has been written, only the newest version is written.
+class WriteQueue {
+public:
+	// Write the given data to the given path, replacing anything that is still
+	// waiting to be written there. If requested, the data is compressed first,
+	// which is also done in the background.
+	static void Add(const std::string &path, std::string data, bool compress = false);
+	// Wait until every file that has been added is written. This must be done
+	// before reading any of those files, and before the game quits.
+	static void Finish();
+};
+
+
+
+#endif
@@ -22,6 +22,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "Dialog.h"
 #include "Files.h"
 #include "text/Font.h"
+#include "text/FontSet.h"
 #include "FrameTimer.h"
 #include "GameData.h"
 #include "GameWindow.h"
@@ -34,6 +35,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "SpriteShader.h"
 #include "Test.h"
 #include "UI.h"
+#include "WriteQueue.h"
 
 #include <chrono>
 #include <iostream>
@@ -139,12 +141,16 @@ int main(int argc, char *argv[])
 	}
 	catch(const runtime_error &error)
 	{
+		WriteQueue::Finish();
 		Audio::Quit();
 		bool doPopUp = testToRunName.empty();
 		GameWindow::ExitWithError(error.what(), doPopUp);
 		return 1;
 	}
 	
+	// Make sure the player's last save has been written.
+	WriteQueue::Finish();
+	
 	// Remember the window state and preferences if quitting normally.
 	Preferences::Set("maximized", GameWindow::IsMaximized());
 	Preferences::Set("fullscreen", GameWindow::IsFullscreen());
@@ -304,6 +310,9 @@ void GameLoop(PlayerInfo &player, const Conversation &conversation, const string
 		}
 		
 		Audio::Step();
+		// Upload any sprites that were asked for since the last frame, and
+		// unload any that have not been drawn recently if memory is short.
+		GameData::StepSprites();
 		
 		// Events in this frame may have cleared out the menu, in which case
 		// we should draw the game panels instead:
@@ -313,6 +322,7 @@ void GameLoop(PlayerInfo &player, const Conversation &conversation, const string
 		
 		GameWindow::Step();
 		CacheBase::Step();
+		FontSet::Step();
 		
 		timer.Wait();
 		
@@ -341,6 +351,10 @@ void PrintHelp()
 	cerr << "    -c, --config <path>: save user's files to given directory." << endl;
 	cerr << "    -d, --debug: turn on debugging features (e.g. Caps Lock slows down instead of speeds up)." << endl;
 	cerr << "    -p, --parse-save: load the most recent saved game and inspect it for content errors" << endl;
+	cerr << "    --data-cache: load unchanged data files from a cache of their parsed contents." << endl;
+	cerr << "    --image-cache: load unchanged sprites from a cache of their decoded images." << endl;
+	cerr << "    --directory-cache: only list resource directories that have changed since the last launch." << endl;
+	cerr << "    --profile-startup: time each step of loading, and save it as a trace in the config folder." << endl;
 	cerr << "    --tests: print table of available tests, then exit." << endl;
 	cerr << "    --test <name>: run given test from resources directory" << endl;
 	cerr << endl;
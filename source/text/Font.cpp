@@ -22,6 +22,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include <algorithm>
 #include <cmath>
 #include <cstring>
+#include <functional>
 #include <stdexcept>
 #include <utility>
 #include <vector>
@@ -31,6 +32,9 @@ using namespace std;
 namespace {
 	bool showUnderlines = false;
 	const int TOTAL_TAB_STOPS = 8;
+	// Texts at least this long are rasterized by the worker thread instead of
+	// stalling the frame in which they are first drawn.
+	const size_t ASYNC_TEXT_LENGTH = 256;
 	
 	// Convert PANGO size to pixel's.
 	int PixelFromPangoCeil(int pangoSize)
@@ -164,10 +168,24 @@ namespace {
 Font::Font()
 {
 	SetUpShader();
-	if(!UpdateSurfaceSize(256, 64, ""))
+	if(!rasterizer.Initialize())
 		throw runtime_error("Initializing error in a constructor of the class Font.");
 	
 	cache.SetUpdateInterval(3600);
+	
+	worker = thread(ref(*this));
+}
+
+
+
+Font::~Font()
+{
+	{
+		lock_guard<mutex> lock(renderMutex);
+		stopping = true;
+	}
+	renderCondition.notify_all();
+	worker.join();
 }
 
 
@@ -243,8 +261,6 @@ int Font::FormattedHeight(const DisplayText &text) const
 		return 0;
 	
 	const RenderedText &renderedText = Render(text);
-	if(!renderedText.texture)
-		return 0;
 	return ToTextCeilY(renderedText.height);
 }
 
@@ -256,8 +272,6 @@ Point Font::FormattedBounds(const DisplayText &text) const
 		return Point();
 	
 	const RenderedText &renderedText = Render(text);
-	if(!renderedText.texture)
-		return Point();
 	return Point(ToTextCeilX(renderedText.width), ToTextCeilY(renderedText.height));
 }
 
@@ -283,6 +297,15 @@ int Font::ParagraphBreak(const Layout &layout) const
 
 
 
+// Get a number that changes whenever the font settings or the screen size
+// change, so the sizes of texts measured before then may be different.
+int Font::Generation() const
+{
+	return generation;
+}
+
+
+
 void Font::ShowUnderlines(bool show) noexcept
 {
 	showUnderlines = show;
@@ -290,6 +313,63 @@ void Font::ShowUnderlines(bool show) noexcept
 
 
 
+// Upload the texts that the worker thread has finished rasterizing, until
+// the given deadline is reached. This must be called from the main thread.
+void Font::UploadRendered(const chrono::steady_clock::time_point &deadline)
+{
+	// At least one text is uploaded each frame, however small the budget is.
+	do {
+		unique_lock<mutex> lock(renderMutex);
+		if(rendered.empty())
+			return;
+		RenderResult result = std::move(rendered.front());
+		rendered.pop();
+		lock.unlock();
+		
+		// Discard the texts that were rasterized with outdated font settings.
+		auto it = pending.find(result.key);
+		if(result.generation != generation || it == pending.end())
+			continue;
+		
+		pending.erase(it);
+		Upload(result.key, result.width, result.height, *result.image);
+	} while(chrono::steady_clock::now() < deadline);
+}
+
+
+
+// Thread entry point for rasterizing long texts.
+void Font::operator()()
+{
+	// The Pango objects used by this thread must also be created by it.
+	Rasterizer threadRasterizer;
+	threadRasterizer.Initialize();
+	
+	while(true)
+	{
+		unique_lock<mutex> lock(renderMutex);
+		while(!stopping && toRender.empty())
+			renderCondition.wait(lock);
+		if(stopping)
+			return;
+		
+		// Copy the settings along with the job, so they match its generation.
+		const RenderJob job = std::move(toRender.front());
+		toRender.pop();
+		const FontSettings settings = workerSettings;
+		lock.unlock();
+		
+		RenderResult result{job.key, job.generation, 0, 0, unique_ptr<ImageBuffer>(new ImageBuffer)};
+		threadRasterizer.SetFont(settings);
+		threadRasterizer.Render(job, result.width, result.height, result.image.get());
+		
+		lock.lock();
+		rendered.push(std::move(result));
+	}
+}
+
+
+
 void Font::DeleterCairoT::operator()(cairo_t *ptr) const
 {
 	cairo_destroy(ptr);
@@ -304,12 +384,197 @@ void Font::DeleterPangoLayout::operator()(PangoLayout *ptr) const
 
 
 
+bool Font::Rasterizer::Initialize()
+{
+	return UpdateSurfaceSize(256, 64, "");
+}
+
+
+
+void Font::Rasterizer::SetFont(const FontSettings &newSettings)
+{
+	if(settings == newSettings)
+		return;
+	
+	settings = newSettings;
+	ApplyFont();
+}
+
+
+
+int Font::Rasterizer::FontHeight() const
+{
+	return fontHeight;
+}
+
+
+
+// Lay out the text and get its size. If an image is given, also rasterize
+// the text into it.
+bool Font::Rasterizer::Render(const RenderJob &job, int &width, int &height, ImageBuffer *image)
+{
+	if(!pangoLayout)
+		return false;
+	
+	const Layout &layout = job.layout;
+	const string &text = job.key.text.GetText();
+	const bool showUnderline = job.key.showUnderline;
+	
+	// Truncate
+	const int layoutWidth = layout.width < 0 ? -1 : layout.width * PANGO_SCALE;
+	pango_layout_set_width(pangoLayout.get(), layoutWidth);
+	pango_layout_set_ellipsize(pangoLayout.get(), ToPangoEllipsizeMode(layout.truncate));
+	
+	// Align and justification
+	const auto alignAndJustify = ToPangoAlignmentAndJustify(layout.align);
+	pango_layout_set_alignment(pangoLayout.get(), alignAndJustify.first);
+	pango_layout_set_justify(pangoLayout.get(), alignAndJustify.second);
+	
+	// Replaces straight quotation marks with curly ones.
+	const string replacedText = ReplaceCharacters(text);
+	
+	// Keyboard Accelerator
+	{
+		char *textRemovedMarkup = nullptr;
+		const char *drawingText = nullptr;
+		PangoAttrList *al = nullptr;
+		GError *error = nullptr;
+		const char accel = showUnderline ? '_' : '\0';
+		const string nonAccelText = RemoveAccelerator(replacedText);
+		const string &parseText = showUnderline ? replacedText : nonAccelText;
+		if(pango_parse_markup(parseText.c_str(), -1, accel, &al, &textRemovedMarkup, 0, &error))
+			drawingText = textRemovedMarkup;
+		else
+		{
+			if(error->message)
+				Files::LogError(error->message);
+			drawingText = nonAccelText.c_str();
+			g_error_free(error);
+		}
+
+		// Set the text and attributes to layout.
+		pango_layout_set_text(pangoLayout.get(), drawingText, -1);
+		pango_layout_set_attributes(pangoLayout.get(), al);
+		pango_attr_list_unref(al);
+		if(textRemovedMarkup)
+			g_free(textRemovedMarkup);
+	}
+	
+	// Check the image buffer size.
+	int textWidth;
+	int textHeight;
+	pango_layout_get_pixel_size(pangoLayout.get(), &textWidth, &textHeight);
+	// Pango draws a PANGO_UNDERLINE_LOW under the logical rectangle,
+	// and an underline may be longer than a text width.
+	PangoRectangle ink_rect;
+	pango_layout_get_pixel_extents(pangoLayout.get(), &ink_rect, nullptr);
+	textHeight = max(textHeight, ink_rect.y + ink_rect.height);
+	textWidth = max(textWidth, ink_rect.x + ink_rect.width);
+	// Check this surface has enough width.
+	if(image && surfaceWidth < textWidth)
+		if(UpdateSurfaceSize(surfaceWidth * ((textWidth / surfaceWidth) + 1),
+			surfaceHeight * ((textHeight / surfaceHeight) + 1), text))
+			return Render(job, width, height, image);
+	
+	// Render
+	if(image)
+		cairo_set_source_rgb(cr.get(), 1.0, 1.0, 1.0);
+	
+	// Control line skips and paragraph breaks manually.
+	const char *layoutText = pango_layout_get_text(pangoLayout.get());
+	auto iter = MakeUniq(pango_layout_get_iter(pangoLayout.get()), pango_layout_iter_free);
+	int y0 = pango_layout_iter_get_baseline(iter.get());
+	int baselineY = PixelFromPangoCeil(y0);
+	int sumExtraY = 0;
+	PangoRectangle logicalRect;
+	if(image)
+	{
+		pango_layout_iter_get_line_extents(iter.get(), nullptr, &logicalRect);
+		cairo_move_to(cr.get(), PixelFromPangoCeil(logicalRect.x), baselineY);
+		pango_cairo_update_layout(cr.get(), pangoLayout.get());
+		PangoLayoutLine *line = pango_layout_iter_get_line_readonly(iter.get());
+		pango_cairo_show_layout_line(cr.get(), line);
+	}
+	while(pango_layout_iter_next_line(iter.get()))
+	{
+		const int y1 = pango_layout_iter_get_baseline(iter.get());
+		const int index = pango_layout_iter_get_index(iter.get());
+		const int diffY = PixelFromPangoCeil(y1 - y0);
+		if(layoutText[index] == '\0')
+		{
+			sumExtraY -= diffY;
+			break;
+		}
+		int add = max(diffY, static_cast<int>(layout.lineHeight));
+		if(index > 0 && layoutText[index - 1] == '\n')
+			add += layout.paragraphBreak;
+		baselineY += add;
+		sumExtraY += add - diffY;
+		if(image)
+		{
+			pango_layout_iter_get_line_extents(iter.get(), nullptr, &logicalRect);
+			cairo_move_to(cr.get(), PixelFromPangoCeil(logicalRect.x), baselineY);
+			pango_cairo_update_layout(cr.get(), pangoLayout.get());
+			PangoLayoutLine *line = pango_layout_iter_get_line_readonly(iter.get());
+			pango_cairo_show_layout_line(cr.get(), line);
+		}
+		y0 = y1;
+	}
+	textHeight += sumExtraY + layout.paragraphBreak;
+	if (layout.lineHeight > fontHeight)
+		textHeight += layout.lineHeight - fontHeight;
+	iter.reset();
+	
+	// When only measuring, the size is limited the same way as the surface is.
+	if(!image)
+	{
+		width = min(textWidth, settings.surfaceWidthLimit);
+		height = min(textHeight, settings.surfaceHeightLimit);
+		return true;
+	}
+	
+	// Check this surface has enough height.
+	if(surfaceHeight < textHeight)
+		if(UpdateSurfaceSize(surfaceWidth, surfaceHeight * ((textHeight / surfaceHeight) + 1), text))
+			return Render(job, width, height, image);
+	
+	// In case of the surface size is smaller than the text size because the text is too large to draw.
+	textWidth = min(textWidth, surfaceWidth);
+	textHeight = min(textHeight, surfaceHeight);
+	
+	// Copy to image buffer and clear the surface.
+	cairo_surface_t *sf = cairo_get_target(cr.get());
+	cairo_surface_flush(sf);
+	image->Allocate(textWidth, textHeight);
+	uint32_t *src = reinterpret_cast<uint32_t*>(cairo_image_surface_get_data(sf));
+	uint32_t *dest = image->Pixels();
+	const int stride = surfaceWidth - textWidth;
+	for(int y = 0; y < textHeight; ++y)
+	{
+		for(int x = 0; x < textWidth; ++x)
+		{
+			*dest = *src;
+			*src = 0;
+			++dest;
+			++src;
+		}
+		src += stride;
+	}
+	cairo_surface_mark_dirty(sf);
+	
+	width = textWidth;
+	height = textHeight;
+	return true;
+}
+
+
+
 // Return true if the surface is updated.
-bool Font::UpdateSurfaceSize(int width, int height, const string &renderingText) const
+bool Font::Rasterizer::UpdateSurfaceSize(int width, int height, const string &renderingText)
 {
 	// Too huge texture will truncate in order to avoid lack of memory.
-	if((surfaceWidth < surfaceWidthLimit && width >= surfaceWidthLimit)
-		|| (surfaceHeight < surfaceHeightLimit && height >= surfaceHeightLimit))
+	if((surfaceWidth < settings.surfaceWidthLimit && width >= settings.surfaceWidthLimit)
+		|| (surfaceHeight < settings.surfaceHeightLimit && height >= settings.surfaceHeightLimit))
 	{
 		string message = "Warning: Reach the maximum limit of the texture size in class Font";
 		if(renderingText.empty())
@@ -319,8 +584,8 @@ bool Font::UpdateSurfaceSize(int width, int height, const string &renderingText)
 		Files::LogError(message);
 	}
 	
-	width = min(width, surfaceWidthLimit);
-	height = min(height, surfaceHeightLimit);
+	width = min(width, settings.surfaceWidthLimit);
+	height = min(height, settings.surfaceHeightLimit);
 	
 	if(surfaceWidth == width && surfaceHeight == height)
 		return false;
@@ -355,44 +620,68 @@ bool Font::UpdateSurfaceSize(int width, int height, const string &renderingText)
 	
 	pango_layout_set_wrap(pangoLayout.get(), PANGO_WRAP_WORD);
 	
-	UpdateFont();
+	ApplyFont();
 	
 	return true;
 }
 
 
 
-void Font::UpdateFont() const
+void Font::Rasterizer::ApplyFont()
 {
-	if(pixelSize <= 0)
+	if(settings.fontSize <= 0 || !pangoLayout)
 		return;
 	
-	cache.Clear();
-	
 	// Get font descriptions.
-	auto fontDesc = MakeUniq(pango_font_description_from_string(drawingSettings.description.c_str()),
+	auto fontDesc = MakeUniq(pango_font_description_from_string(settings.description.c_str()),
 		pango_font_description_free);
 	
 	// Set the pixel size.
-	const int fontSize = ToViewportFloorY(pixelSize) * PANGO_SCALE;
-	pango_font_description_set_absolute_size(fontDesc.get(), fontSize);
+	pango_font_description_set_absolute_size(fontDesc.get(), settings.fontSize);
 	
 	// Update the context.
-	PangoLanguage *lang = pango_language_from_string(drawingSettings.language.c_str());
+	PangoLanguage *lang = pango_language_from_string(settings.language.c_str());
 	pango_context_set_language(context, lang);
 	
 	// Update the layout.
 	pango_layout_set_font_description(pangoLayout.get(), fontDesc.get());
 	
-	// Update layout parameters.
+	// Update the font height.
 	auto metrics = MakeUniq(pango_context_get_metrics(context, fontDesc.get(), lang),
 		pango_font_metrics_unref);
 	const int ascent = pango_font_metrics_get_ascent(metrics.get());
 	const int descent = pango_font_metrics_get_descent(metrics.get());
-	viewportFontHeight = PixelFromPangoCeil(ascent + descent);
+	fontHeight = PixelFromPangoCeil(ascent + descent);
 	metrics.reset();
 	fontDesc.reset();
 	
+	// Tab Stop
+	auto tb = MakeUniq(pango_tab_array_new(TOTAL_TAB_STOPS, FALSE), pango_tab_array_free);
+	for(int i = 0; i < TOTAL_TAB_STOPS; ++i)
+		pango_tab_array_set_tab(tb.get(), i, PANGO_TAB_LEFT, i * settings.tabSize);
+	pango_layout_set_tabs(pangoLayout.get(), tb.get());
+}
+
+
+
+void Font::UpdateFont() const
+{
+	if(pixelSize <= 0)
+		return;
+	
+	cache.Clear();
+	pending.clear();
+	++generation;
+	
+	// Set the font descriptions and the pixel size.
+	fontSettings.description = drawingSettings.description;
+	fontSettings.language = drawingSettings.language;
+	fontSettings.fontSize = ToViewportFloorY(pixelSize) * PANGO_SCALE;
+	rasterizer.SetFont(fontSettings);
+	
+	// Update layout parameters.
+	viewportFontHeight = rasterizer.FontHeight();
+	
 	if (drawingSettings.lineHeightScale >= 0.)
 		viewportDefaultLineHeight = viewportFontHeight * drawingSettings.lineHeightScale;
 	else
@@ -403,12 +692,14 @@ void Font::UpdateFont() const
 		viewportDefaultParagraphBreak = 0.;
 	
 	// Tab Stop
-	auto tb = MakeUniq(pango_tab_array_new(TOTAL_TAB_STOPS, FALSE), pango_tab_array_free);
 	space = WidthInViewport(DisplayText(" ", {}));
-	const int tabSize = 4 * space * PANGO_SCALE;
-	for(int i = 0; i < TOTAL_TAB_STOPS; ++i)
-		pango_tab_array_set_tab(tb.get(), i, PANGO_TAB_LEFT, i * tabSize);
-	pango_layout_set_tabs(pangoLayout.get(), tb.get());
+	fontSettings.tabSize = 4 * space * PANGO_SCALE;
+	rasterizer.SetFont(fontSettings);
+	
+	// Texts queued with the old settings are not needed any more.
+	lock_guard<mutex> lock(renderMutex);
+	toRender = queue<RenderJob>();
+	workerSettings = fontSettings;
 }
 
 
@@ -429,8 +720,8 @@ void Font::DrawCommon(const DisplayText &text, double x, double y, const Color &
 		// Use the view port size as a rough estimation of the RAM size of the VIDEO system.
 		// The surface size is larger than the initial size because the surface is never shrunk.
 		// UpdateFont() will clear all caches.
-		surfaceWidthLimit = viewportWidth * 2;
-		surfaceHeightLimit = viewportHeight * 2;
+		fontSettings.surfaceWidthLimit = viewportWidth * 2;
+		fontSettings.surfaceHeightLimit = viewportHeight * 2;
 		
 		UpdateFont();
 	}
@@ -484,137 +775,44 @@ const Font::RenderedText &Font::Render(const DisplayText &text) const
 	if(cached.second)
 		return *cached.first;
 	
-	// Use viewport coodinates in this function.
-	const Layout layout = ToViewport(text.GetLayout());
-	
-	// Truncate
-	const int layoutWidth = layout.width < 0 ? -1 : layout.width * PANGO_SCALE;
-	pango_layout_set_width(pangoLayout.get(), layoutWidth);
-	pango_layout_set_ellipsize(pangoLayout.get(), ToPangoEllipsizeMode(layout.truncate));
-	
-	// Align and justification
-	const auto alignAndJustify = ToPangoAlignmentAndJustify(layout.align);
-	pango_layout_set_alignment(pangoLayout.get(), alignAndJustify.first);
-	pango_layout_set_justify(pangoLayout.get(), alignAndJustify.second);
-	
-	// Replaces straight quotation marks with curly ones.
-	const string replacedText = ReplaceCharacters(text.GetText());
-	
-	// Keyboard Accelerator
-	{
-		char *textRemovedMarkup = nullptr;
-		const char *drawingText = nullptr;
-		PangoAttrList *al = nullptr;
-		GError *error = nullptr;
-		const char accel = showUnderlines ? '_' : '\0';
-		const string nonAccelText = RemoveAccelerator(replacedText);
-		const string &parseText = showUnderlines ? replacedText : nonAccelText;
-		if(pango_parse_markup(parseText.c_str(), -1, accel, &al, &textRemovedMarkup, 0, &error))
-			drawingText = textRemovedMarkup;
-		else
-		{
-			if(error->message)
-				Files::LogError(error->message);
-			drawingText = nonAccelText.c_str();
-			g_error_free(error);
-		}
-
-		// Set the text and attributes to layout.
-		pango_layout_set_text(pangoLayout.get(), drawingText, -1);
-		pango_layout_set_attributes(pangoLayout.get(), al);
-		pango_attr_list_unref(al);
-		if(textRemovedMarkup)
-			g_free(textRemovedMarkup);
-	}
-	
-	// Check the image buffer size.
-	int textWidth;
-	int textHeight;
-	pango_layout_get_pixel_size(pangoLayout.get(), &textWidth, &textHeight);
-	// Pango draws a PANGO_UNDERLINE_LOW under the logical rectangle,
-	// and an underline may be longer than a text width.
-	PangoRectangle ink_rect;
-	pango_layout_get_pixel_extents(pangoLayout.get(), &ink_rect, nullptr);
-	textHeight = max(textHeight, ink_rect.y + ink_rect.height);
-	textWidth = max(textWidth, ink_rect.x + ink_rect.width);
-	// Check this surface has enough width.
-	if(surfaceWidth < textWidth)
-		if(UpdateSurfaceSize(surfaceWidth * ((textWidth / surfaceWidth) + 1),
-			surfaceHeight * ((textHeight / surfaceHeight) + 1), text.GetText()))
-			return Render(text);
+	// Return the measured size if the worker thread is still rasterizing it.
+	auto it = pending.find(key);
+	if(it != pending.end())
+		return it->second;
 	
-	// Render
-	cairo_set_source_rgb(cr.get(), 1.0, 1.0, 1.0);
+	// Use viewport coodinates in the rasterizer.
+	const RenderJob job{key, ToViewport(text.GetLayout()), generation};
+	int textWidth = 0;
+	int textHeight = 0;
 	
-	// Control line skips and paragraph breaks manually.
-	const char *layoutText = pango_layout_get_text(pangoLayout.get());
-	auto iter = MakeUniq(pango_layout_get_iter(pangoLayout.get()), pango_layout_iter_free);
-	int y0 = pango_layout_iter_get_baseline(iter.get());
-	int baselineY = PixelFromPangoCeil(y0);
-	int sumExtraY = 0;
-	PangoRectangle logicalRect;
-	pango_layout_iter_get_line_extents(iter.get(), nullptr, &logicalRect);
-	cairo_move_to(cr.get(), PixelFromPangoCeil(logicalRect.x), baselineY);
-	pango_cairo_update_layout(cr.get(), pangoLayout.get());
-	PangoLayoutLine *line = pango_layout_iter_get_line_readonly(iter.get());
-	pango_cairo_show_layout_line(cr.get(), line);
-	while(pango_layout_iter_next_line(iter.get()))
+	// Short texts are rasterized right away.
+	if(text.GetText().length() < ASYNC_TEXT_LENGTH)
 	{
-		const int y1 = pango_layout_iter_get_baseline(iter.get());
-		const int index = pango_layout_iter_get_index(iter.get());
-		const int diffY = PixelFromPangoCeil(y1 - y0);
-		if(layoutText[index] == '\0')
-		{
-			sumExtraY -= diffY;
-			break;
-		}
-		int add = max(diffY, static_cast<int>(layout.lineHeight));
-		if(index > 0 && layoutText[index - 1] == '\n')
-			add += layout.paragraphBreak;
-		baselineY += add;
-		sumExtraY += add - diffY;
-		pango_layout_iter_get_line_extents(iter.get(), nullptr, &logicalRect);
-		cairo_move_to(cr.get(), PixelFromPangoCeil(logicalRect.x), baselineY);
-		pango_cairo_update_layout(cr.get(), pangoLayout.get());
-		line = pango_layout_iter_get_line_readonly(iter.get());
-		pango_cairo_show_layout_line(cr.get(), line);
-		y0 = y1;
+		ImageBuffer image;
+		rasterizer.Render(job, textWidth, textHeight, &image);
+		return Upload(key, textWidth, textHeight, image);
 	}
-	textHeight += sumExtraY + layout.paragraphBreak;
-	if (layout.lineHeight > viewportFontHeight)
-		textHeight += layout.lineHeight - viewportFontHeight;
-	iter.reset();
 	
-	// Check this surface has enough height.
-	if(surfaceHeight < textHeight)
-		if(UpdateSurfaceSize(surfaceWidth, surfaceHeight * ((textHeight / surfaceHeight) + 1), text.GetText()))
-			return Render(text);
-	
-	// In case of the surface size is smaller than the text size because the text is too large to draw.
-	textWidth = min(textWidth, surfaceWidth);
-	textHeight = min(textHeight, surfaceHeight);
-	
-	// Copy to image buffer and clear the surface.
-	cairo_surface_t *sf = cairo_get_target(cr.get());
-	cairo_surface_flush(sf);
-	ImageBuffer image;
-	image.Allocate(textWidth, textHeight);
-	uint32_t *src = reinterpret_cast<uint32_t*>(cairo_image_surface_get_data(sf));
-	uint32_t *dest = image.Pixels();
-	const int stride = surfaceWidth - textWidth;
-	for(int y = 0; y < textHeight; ++y)
+	// Long texts are only laid out here, because the callers need their size
+	// right away. They are not drawn until the worker thread rasterizes them.
+	rasterizer.Render(job, textWidth, textHeight, nullptr);
+	RenderedText measured = {0, textWidth, textHeight, Point(.5 * textWidth, .5 * textHeight)};
+	it = pending.emplace(key, measured).first;
 	{
-		for(int x = 0; x < textWidth; ++x)
-		{
-			*dest = *src;
-			*src = 0;
-			++dest;
-			++src;
-		}
-		src += stride;
+		lock_guard<mutex> lock(renderMutex);
+		toRender.push(job);
 	}
-	cairo_surface_mark_dirty(sf);
+	renderCondition.notify_one();
 	
+	return it->second;
+}
+
+
+
+// Upload the given image as the texture of a text and add it to the cache.
+const Font::RenderedText &Font::Upload(const CacheKey &key, int textWidth, int textHeight,
+	const ImageBuffer &image) const
+{
 	// Try to reuse an old texture.
 	GLuint texture = 0;
 	auto recycled = cache.Recycle();
@@ -741,8 +939,6 @@ int Font::WidthInViewport(const DisplayText &text) const
 		return 0;
 	
 	const RenderedText &renderedText = Render(text);
-	if(!renderedText.texture)
-		return 0;
 	return renderedText.width;
 }
 
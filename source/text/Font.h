@@ -21,9 +21,15 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 
 #include "../gl_header.h"
 
+#include <chrono>
+#include <condition_variable>
 #include <cstddef>
 #include <memory>
+#include <mutex>
+#include <queue>
 #include <string>
+#include <thread>
+#include <unordered_map>
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wold-style-cast"
 #include <pango/pangocairo.h>
@@ -52,7 +58,7 @@ public:
 	
 public:
 	Font();
-	~Font() = default;
+	~Font();
 	Font(const Font &a) = delete;
 	Font &operator=(const Font &a) = delete;
 	
@@ -81,9 +87,19 @@ public:
 	// Get the line height and paragraph break.
 	int LineHeight(const Layout &layout = {}) const;
 	int ParagraphBreak(const Layout &layout = {}) const;
+	// Get a number that changes whenever the font settings or the screen size
+	// change, so the sizes of texts measured before then may be different.
+	int Generation() const;
 	
 	static void ShowUnderlines(bool show) noexcept;
 	
+	// Upload the texts that the worker thread has finished rasterizing, until
+	// the given deadline is reached. This must be called from the main thread.
+	void UploadRendered(const std::chrono::steady_clock::time_point &deadline);
+	
+	// Thread entry point for rasterizing long texts.
+	void operator()();
+	
 private:
 	// Text rendered as a sprite.
 	struct RenderedText {
@@ -127,13 +143,72 @@ private:
 		void operator()(PangoLayout *ptr) const;
 	};
 	
+	// Everything a rasterizer needs to know about the font, in viewport pixels.
+	struct FontSettings {
+		std::string description;
+		std::string language;
+		int fontSize = 0;
+		int tabSize = 0;
+		int surfaceWidthLimit = 10000;
+		int surfaceHeightLimit = 10000;
+		
+		bool operator==(const FontSettings &rhs) const noexcept;
+	};
+	
+	// A text to lay out, with a layout already converted to viewport coordinates.
+	struct RenderJob {
+		CacheKey key;
+		Layout layout;
+		// The font settings are only valid for this generation of the font.
+		int generation;
+	};
+	
+	// The pixels and size of a text that the worker thread has rasterized.
+	struct RenderResult {
+		CacheKey key;
+		int generation;
+		int width;
+		int height;
+		std::unique_ptr<ImageBuffer> image;
+	};
+	
+	// The Pango and Cairo state used to lay out and rasterize texts. Pango
+	// objects must not be shared between threads, so each thread that renders
+	// text has its own instance.
+	class Rasterizer {
+	public:
+		// Allocate the initial surface. Return false if that fails.
+		bool Initialize();
+		// Apply the given font settings, if they differ from the current ones.
+		void SetFont(const FontSettings &newSettings);
+		// Get the height of the font, in viewport pixels.
+		int FontHeight() const;
+		// Lay out the text and get its size. If an image is given, also
+		// rasterize the text into it. Return false if the text cannot be drawn.
+		bool Render(const RenderJob &job, int &width, int &height, ImageBuffer *image);
+		
+	private:
+		bool UpdateSurfaceSize(int width, int height, const std::string &renderingText);
+		void ApplyFont();
+		
+	private:
+		FontSettings settings;
+		std::unique_ptr<cairo_t, DeleterCairoT> cr;
+		PangoContext *context = nullptr;
+		std::unique_ptr<PangoLayout, DeleterPangoLayout> pangoLayout;
+		int surfaceWidth = 0;
+		int surfaceHeight = 0;
+		int fontHeight = 0;
+	};
+	
 	
 private:
-	bool UpdateSurfaceSize(int width, int height, const std::string &redneringText) const;
 	void UpdateFont() const;
 	
 	void DrawCommon(const DisplayText &text, double x, double y, const Color &color, bool alignToDot) const;
 	const RenderedText &Render(const DisplayText &text) const;
+	// Upload the given image as the texture of a text and add it to the cache.
+	const RenderedText &Upload(const CacheKey &key, int width, int height, const ImageBuffer &image) const;
 	void SetUpShader();
 	
 	int WidthInViewport(const DisplayText &text) const;
@@ -176,17 +251,29 @@ private:
 	DrawingSettings drawingSettings;
 	mutable int space = 0;
 	
-	// For rendering.
-	mutable std::unique_ptr<cairo_t, DeleterCairoT> cr;
-	mutable PangoContext *context = nullptr;
-	mutable std::unique_ptr<PangoLayout, DeleterPangoLayout> pangoLayout;
-	mutable int surfaceWidth = 0;
-	mutable int surfaceHeight = 0;
-	mutable int surfaceWidthLimit = 10000;
-	mutable int surfaceHeightLimit = 10000;
+	// For rendering on the main thread.
+	mutable FontSettings fontSettings;
+	mutable Rasterizer rasterizer;
 	
 	// Cache of rendered text.
 	mutable Cache<CacheKey, RenderedText, true, CacheKeyHash, AtRecycleForRenderedText> cache;
+	
+	// Long texts that have been measured but are still waiting for the worker
+	// thread to rasterize them. They have no texture yet.
+	mutable std::unordered_map<CacheKey, RenderedText, CacheKeyHash> pending;
+	// Any change of the font settings starts a new generation, so that texts
+	// rasterized with the old settings are discarded.
+	mutable int generation = 0;
+	
+	// Communication with the worker thread.
+	mutable std::queue<RenderJob> toRender;
+	mutable std::queue<RenderResult> rendered;
+	// The worker thread's copy of the font settings.
+	mutable FontSettings workerSettings;
+	mutable std::mutex renderMutex;
+	mutable std::condition_variable renderCondition;
+	bool stopping = false;
+	std::thread worker;
 };
 
 
@@ -205,6 +292,15 @@ inline bool Font::CacheKey::operator==(const CacheKey &rhs) const noexcept
 
 
 
+inline bool Font::FontSettings::operator==(const FontSettings &rhs) const noexcept
+{
+	return description == rhs.description && language == rhs.language && fontSize == rhs.fontSize
+		&& tabSize == rhs.tabSize && surfaceWidthLimit == rhs.surfaceWidthLimit
+		&& surfaceHeightLimit == rhs.surfaceHeightLimit;
+}
+
+
+
 inline Font::CacheKeyHash::result_type Font::CacheKeyHash::operator() (argument_type const &s) const noexcept
 {
 	const std::string &text = s.text.GetText();
@@ -14,6 +14,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 
 #include "../Files.h"
 
+#include <chrono>
 #include <cstdlib>
 #include <map>
 #include <fontconfig/fontconfig.h>
@@ -25,6 +26,9 @@ namespace {
 	
 	Font::DrawingSettings drawingSettings;
 	char envBackend[] = "PANGOCAIRO_BACKEND=fc";
+	
+	// The time in each frame that may be spent uploading text textures.
+	const chrono::milliseconds UPLOAD_BUDGET(2);
 }
 
 
@@ -65,3 +69,12 @@ void FontSet::SetDrawingSettings(const Font::DrawingSettings &settings)
 	for(auto &it : fonts)
 		it.second.SetDrawingSettings(drawingSettings);
 }
+
+
+
+void FontSet::Step()
+{
+	const auto deadline = chrono::steady_clock::now() + UPLOAD_BUDGET;
+	for(auto &it : fonts)
+		it.second.UploadRendered(deadline);
+}
@@ -27,6 +27,10 @@ public:
 	
 	// Set the drawing settins.
 	static void SetDrawingSettings(const Font::DrawingSettings &setting);
+	
+	// Upload the texts that have been rasterized in the background. This is
+	// called once per frame, and only spends a small part of the frame on it.
+	static void Step();
 };
 
 
@@ -20,6 +20,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include <fstream>
 #include <memory>
 #include <set>
+#include <sstream>
 #include <iostream>
 using namespace std;
 
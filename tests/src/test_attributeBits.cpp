@@ -0,0 +1,61 @@
+/* test_attributeBits.cpp
+Copyright (c) 2021 by Michael Zahniser
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../source/AttributeBits.h"
+
+// ... and any system includes needed for the test file.
+#include <set>
+#include <string>
+
+namespace { // test namespace
+
+// #region unit tests
+SCENARIO( "Checking whether attribute sets intersect", "[AttributeBits]" ) {
+	GIVEN( "a few sets of attributes" ) {
+		auto planet = AttributeBits(std::set<std::string>{"spaceport", "shipyard", "rich"});
+		auto poor = AttributeBits(std::set<std::string>{"poor", "mining"});
+		auto wealthy = AttributeBits(std::set<std::string>{"rich", "urban"});
+		
+		THEN( "sets with a common attribute intersect" ) {
+			CHECK( planet.Intersects(wealthy) );
+			CHECK( wealthy.Intersects(planet) );
+		}
+		THEN( "sets without one do not" ) {
+			CHECK_FALSE( planet.Intersects(poor) );
+			CHECK_FALSE( poor.Intersects(wealthy) );
+			CHECK_FALSE( planet.Intersects(AttributeBits()) );
+		}
+	}
+	GIVEN( "more attributes than fit in one word" ) {
+		std::set<std::string> many;
+		for(int i = 0; i < 200; ++i)
+			many.insert("attribute " + std::to_string(i));
+		auto all = AttributeBits(many);
+		auto last = AttributeBits(std::set<std::string>{"attribute 199"});
+		auto first = AttributeBits(std::set<std::string>{"attribute 0"});
+		
+		THEN( "attributes in any word are found" ) {
+			CHECK( all.Intersects(last) );
+			CHECK( last.Intersects(all) );
+			CHECK( all.Intersects(first) );
+			CHECK_FALSE( first.Intersects(last) );
+		}
+	}
+}
+// #endregion unit tests
+
+
+
+} // test namespace
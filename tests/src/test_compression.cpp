@@ -0,0 +1,144 @@
+/* test_compression.cpp
+Copyright (c) 2021 by Michael Zahniser
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../source/Compression.h"
+
+// ... and any system includes needed for the test file.
+#include <cstdint>
+#include <string>
+
+namespace { // test namespace
+
+// #region mock data
+
+// Text that looks like a saved game, long enough to be split into more than
+// one chunk when it is compressed as a file.
+std::string SaveLike()
+{
+	std::string data = "pilot Test Pilot\ndate 16 11 3013\nsystem Sol\nplanet Earth\n";
+	for(int i = 0; data.size() < 3000000; ++i)
+	{
+		data += "ship \"Star Barge\"\n\tname \"Barge " + std::to_string(i) + "\"\n";
+		data += "\tposition " + std::to_string(i * 37 % 1000) + " " + std::to_string(i * 91 % 1000) + "\n";
+		data += "\tattributes\n\t\tcategory \"Light Freighter\"\n\t\t\"cargo space\" 50\n";
+	}
+	return data;
+}
+
+// Bytes with no repeated patterns, which cannot be compressed.
+std::string Incompressible()
+{
+	std::string data;
+	uint32_t state = 12345;
+	for(int i = 0; i < 100000; ++i)
+	{
+		state = state * 1664525 + 1013904223;
+		data += static_cast<char>(state >> 24);
+	}
+	return data;
+}
+
+// Compress the given data as a file, then decompress it again.
+bool RoundTrip(const std::string &data, std::string &result)
+{
+	std::string compressed;
+	Compression::CompressFile(data.data(), data.size(), compressed);
+	if(!Compression::IsFile(compressed.data(), compressed.size()))
+		return false;
+	return Compression::DecompressFile(compressed.data(), compressed.size(), result);
+}
+
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Compressing a file and decompressing it", "[Compression]" ) {
+	GIVEN( "Data that looks like a saved game" ) {
+		const std::string data = SaveLike();
+		THEN( "it is decompressed exactly as it was" ) {
+			std::string result;
+			CHECK( RoundTrip(data, result) );
+			CHECK( result == data );
+		}
+		THEN( "it is smaller once compressed" ) {
+			std::string compressed;
+			Compression::CompressFile(data.data(), data.size(), compressed);
+			CHECK( compressed.size() < data.size() / 2 );
+		}
+	}
+	GIVEN( "Empty data" ) {
+		THEN( "it is decompressed as empty data" ) {
+			std::string result;
+			CHECK( RoundTrip(std::string(), result) );
+			CHECK( result.empty() );
+		}
+	}
+	GIVEN( "Data that cannot be compressed" ) {
+		const std::string data = Incompressible();
+		THEN( "it is decompressed exactly as it was" ) {
+			std::string result;
+			CHECK( RoundTrip(data, result) );
+			CHECK( result == data );
+		}
+	}
+	GIVEN( "Data that is not a compressed file" ) {
+		const std::string data = "pilot Test Pilot\n";
+		THEN( "it is not recognized as one" ) {
+			std::string result;
+			CHECK_FALSE( Compression::IsFile(data.data(), data.size()) );
+			CHECK_FALSE( Compression::DecompressFile(data.data(), data.size(), result) );
+		}
+	}
+	GIVEN( "The beginning of a compressed file" ) {
+		const std::string data = SaveLike();
+		std::string compressed;
+		Compression::CompressFile(data.data(), data.size(), compressed);
+		size_t size = Compression::FirstChunkSize(compressed.data(), 16);
+		THEN( "its first chunk can be decompressed on its own" ) {
+			REQUIRE( size );
+			REQUIRE( size < compressed.size() );
+			std::string result;
+			CHECK( Compression::DecompressFile(compressed.data(), size, result) );
+			CHECK( !result.empty() );
+			CHECK( result.size() < data.size() );
+			CHECK( data.compare(0, result.size(), result) == 0 );
+		}
+	}
+	GIVEN( "A file that is not compressed or has no chunks" ) {
+		std::string empty;
+		Compression::CompressFile(nullptr, 0, empty);
+		const std::string text = "pilot Test Pilot\ndate 16 11 3013\n";
+		THEN( "it has no first chunk" ) {
+			CHECK( Compression::FirstChunkSize(empty.data(), empty.size()) == 0 );
+			CHECK( Compression::FirstChunkSize(text.data(), text.size()) == 0 );
+		}
+	}
+	GIVEN( "A compressed file that has been cut short" ) {
+		const std::string data = SaveLike();
+		std::string compressed;
+		Compression::CompressFile(data.data(), data.size(), compressed);
+		compressed.resize(compressed.size() / 2);
+		THEN( "it is reported as damaged" ) {
+			std::string result;
+			CHECK_FALSE( Compression::DecompressFile(compressed.data(), compressed.size(), result) );
+		}
+	}
+}
+// #endregion unit tests
+
+
+
+} // test namespace
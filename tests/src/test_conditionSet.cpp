@@ -136,7 +136,7 @@ SCENARIO( "Determining if condition requirements are met", "[ConditionSet][Usage
 
 SCENARIO( "Applying changes to conditions", "[ConditionSet][Usage]" ) {
 	auto mutableList = ConditionSet::Conditions{};
-	REQUIRE( mutableList.empty() );
+	REQUIRE( mutableList.IsEmpty() );
 	
 	GIVEN( "an empty ConditionSet" ) {
 		const auto emptySet = ConditionSet{};
@@ -144,12 +144,12 @@ SCENARIO( "Applying changes to conditions", "[ConditionSet][Usage]" ) {
 		
 		THEN( "no conditions are added via Apply" ) {
 			emptySet.Apply(mutableList);
-			REQUIRE( mutableList.empty() );
+			REQUIRE( mutableList.IsEmpty() );
 			
-			mutableList.emplace("event: war begins", 1);
-			REQUIRE( mutableList.size() == 1 );
+			mutableList["event: war begins"] = 1;
+			REQUIRE( mutableList.Size() == 1 );
 			emptySet.Apply(mutableList);
-			REQUIRE( mutableList.size() == 1 );
+			REQUIRE( mutableList.Size() == 1 );
 		}
 	}
 	GIVEN( "a ConditionSet with only comparison expressions" ) {
@@ -162,12 +162,12 @@ SCENARIO( "Applying changes to conditions", "[ConditionSet][Usage]" ) {
 		
 		THEN( "no conditions are added via Apply" ) {
 			compareSet.Apply(mutableList);
-			REQUIRE( mutableList.empty() );
+			REQUIRE( mutableList.IsEmpty() );
 			
-			mutableList.emplace("event: war begins", 1);
-			REQUIRE( mutableList.size() == 1 );
+			mutableList["event: war begins"] = 1;
+			REQUIRE( mutableList.Size() == 1 );
 			compareSet.Apply(mutableList);
-			REQUIRE( mutableList.size() == 1 );
+			REQUIRE( mutableList.Size() == 1 );
 		}
 	}
 	GIVEN( "a ConditionSet with an assignable expression" ) {
@@ -176,11 +176,45 @@ SCENARIO( "Applying changes to conditions", "[ConditionSet][Usage]" ) {
 		
 		THEN( "the condition list is updated via Apply" ) {
 			applySet.Apply(mutableList);
-			REQUIRE_FALSE( mutableList.empty() );
+			REQUIRE_FALSE( mutableList.IsEmpty() );
 			
-			const auto &inserted = mutableList.find("year");
-			REQUIRE( inserted != mutableList.end() );
-			CHECK( inserted->second == 3013 );
+			REQUIRE( mutableList.Has("year") );
+			CHECK( mutableList.Get("year") == 3013 );
+		}
+	}
+}
+
+SCENARIO( "Evaluating complex expressions", "[ConditionSet][Usage]" ) {
+	const auto conditionList = ConditionSet::Conditions{
+		{"a", 7},
+		{"b", -3},
+		{"combat rating", 12},
+	};
+	GIVEN( "expressions with several operators" ) {
+		auto expression = GENERATE(as<std::string>{}
+			, "a + b * 2 == 1"
+			, "( a + b ) * 2 == 8"
+			, "a - b - 2 == 8"
+			, "\"combat rating\" / ( a - 3 ) + 1 == 4"
+			, "( ( a ) ) * ( b + ( 1 ) ) == -14"
+			, "2 * 3 + 4 * 5 == 26"
+			, "unset * 5 + a == 7"
+		);
+		const auto set = ConditionSet{AsDataNode("and\n\t" + expression)};
+		REQUIRE_FALSE( set.IsEmpty() );
+		
+		THEN( "operator precedence and parentheses are respected" ) {
+			CAPTURE( expression );
+			CHECK( set.Test(conditionList) );
+		}
+	}
+	GIVEN( "a temporary condition that is then tested" ) {
+		const auto set = ConditionSet{AsDataNode("and\n\ttemp = a * ( b + 5 )\n\ttemp == 14")};
+		REQUIRE_FALSE( set.IsEmpty() );
+		
+		THEN( "the temporary value is used" ) {
+			CHECK( set.Test(conditionList) );
+			CHECK_FALSE( conditionList.Has("temp") );
 		}
 	}
 }
@@ -0,0 +1,173 @@
+/* test_conditionsStore.cpp
+Copyright (c) 2021 by Michael Zahniser
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../source/ConditionsStore.h"
+
+// ... and any system includes needed for the test file.
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace { // test namespace
+
+// #region mock data
+
+// Get the names and values in a store as a map, which is always sorted.
+std::map<std::string, int64_t> AsMap(const ConditionsStore &store, const std::string &prefix = "")
+{
+	std::map<std::string, int64_t> result;
+	for(const auto &it : store.List(prefix))
+		result.insert(it);
+	return result;
+}
+
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Storing conditions", "[ConditionsStore]" ) {
+	GIVEN( "an empty store" ) {
+		auto store = ConditionsStore{};
+		REQUIRE( store.IsEmpty() );
+		
+		THEN( "unset conditions have a value of 0" ) {
+			CHECK( store.Get("never set") == 0 );
+			CHECK_FALSE( store.Has("never set") );
+			CHECK( store.IsEmpty() );
+		}
+		THEN( "conditions can be set to any value, including 0" ) {
+			store["a"] = 3;
+			store["b"] = 0;
+			CHECK( store.Get("a") == 3 );
+			CHECK( store.Has("b") );
+			CHECK( store.Size() == 2 );
+		}
+	}
+	GIVEN( "a store with many conditions" ) {
+		auto store = ConditionsStore{};
+		std::map<std::string, int64_t> expected;
+		for(int i = 0; i < 1000; ++i)
+		{
+			std::string name = "condition " + std::to_string(i);
+			store[name] = i;
+			expected[name] = i;
+		}
+		REQUIRE( store.Size() == 1000 );
+		
+		THEN( "all of them are listed in order" ) {
+			std::vector<std::pair<std::string, int64_t>> list = store.List();
+			REQUIRE( list.size() == expected.size() );
+			CHECK( std::vector<std::pair<std::string, int64_t>>(expected.begin(), expected.end()) == list );
+		}
+		THEN( "erasing some of them leaves the rest unchanged" ) {
+			for(int i = 0; i < 1000; i += 3)
+			{
+				std::string name = "condition " + std::to_string(i);
+				store.Erase(name);
+				expected.erase(name);
+			}
+			CHECK( store.Size() == expected.size() );
+			for(int i = 0; i < 1000; ++i)
+			{
+				std::string name = "condition " + std::to_string(i);
+				CHECK( store.Has(name) == (i % 3 != 0) );
+				CHECK( store.Get(name) == (i % 3 ? i : 0) );
+			}
+			CHECK( AsMap(store) == expected );
+		}
+	}
+}
+
+SCENARIO( "Listing conditions by prefix", "[ConditionsStore]" ) {
+	GIVEN( "a store with salaries, tributes, and other conditions" ) {
+		auto store = ConditionsStore{
+			{"salary: Free Worlds", 500},
+			{"salary: Alpha", 100},
+			{"tribute: Earth", 1000},
+			{"salaryman", 1},
+			{"test: one", 1},
+			{"test: two", 2},
+		};
+		THEN( "each family is listed in order" ) {
+			std::vector<std::pair<std::string, int64_t>> salaries = {
+				{"salary: Alpha", 100},
+				{"salary: Free Worlds", 500}
+			};
+			CHECK( store.List("salary: ") == salaries );
+			CHECK( store.List("tribute: ").size() == 1 );
+		}
+		THEN( "other prefixes are also found" ) {
+			CHECK( store.List("test: ").size() == 2 );
+			CHECK( store.List("salary").size() == 3 );
+		}
+		THEN( "a family can be erased all at once" ) {
+			store.ErasePrefix("salary: ");
+			CHECK( store.List("salary: ").empty() );
+			CHECK( store.Has("salaryman") );
+			CHECK( store.Size() == 4 );
+		}
+		THEN( "erased family members are no longer listed" ) {
+			store.Erase("tribute: Earth");
+			CHECK( store.List("tribute: ").empty() );
+			store["tribute: Earth"] = 2000;
+			CHECK( store.List("tribute: ").front().second == 2000 );
+		}
+	}
+}
+
+SCENARIO( "Finding which conditions were modified", "[ConditionsStore]" ) {
+	GIVEN( "a store with a few conditions" ) {
+		auto store = ConditionsStore{{"a", 1}, {"b", 2}, {"c", 3}};
+		uint64_t stamp = store.Stamp();
+		std::vector<int> slots;
+		
+		THEN( "nothing has changed if nothing was modified" ) {
+			CHECK( store.Get("a") == 1 );
+			REQUIRE( store.Changed(stamp, slots) );
+			CHECK( slots.empty() );
+		}
+		THEN( "modified and erased conditions are listed once each" ) {
+			store["b"] = 5;
+			store["b"] += 1;
+			store.Erase("c");
+			store.Erase("never set");
+			REQUIRE( store.Changed(stamp, slots) );
+			REQUIRE( slots.size() == 2 );
+			CHECK( (store[slots[0]] == 6 || store[slots[1]] == 6) );
+		}
+		THEN( "only modifications since the stamp are listed" ) {
+			store["a"] = 2;
+			stamp = store.Stamp();
+			REQUIRE( store.Changed(stamp, slots) );
+			CHECK( slots.empty() );
+		}
+		THEN( "clearing or replacing the store modifies everything" ) {
+			store.Clear();
+			CHECK_FALSE( store.Changed(stamp, slots) );
+			stamp = store.Stamp();
+			store = ConditionsStore{{"a", 1}};
+			CHECK_FALSE( store.Changed(stamp, slots) );
+			CHECK( store.Get("a") == 1 );
+		}
+	}
+}
+// #endregion unit tests
+
+
+
+} // test namespace
@@ -0,0 +1,171 @@
+/* test_datawriter.cpp
+Copyright (c) 2021 by Michael Zahniser
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../source/DataWriter.h"
+
+// ... and any system includes needed for the test file.
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <sstream>
+#include <string>
+
+namespace { // test namespace
+
+// #region mock data
+
+// Numbers used to be written by a stream with a precision of 8 digits, and
+// must still be written exactly the same way.
+template <class Type>
+std::string StreamFormat(Type value)
+{
+	std::ostringstream out;
+	out.precision(8);
+	out << value;
+	return out.str();
+}
+
+template <class Type>
+std::string WriterFormat(Type value)
+{
+	DataWriter writer("");
+	writer.WriteToken(value);
+	return writer.GetString();
+}
+
+// Check whether a file exists, and read its entire contents.
+bool FileExists(const std::string &path)
+{
+	return std::ifstream(path).good();
+}
+
+std::string ReadFile(const std::string &path)
+{
+	std::ifstream in(path, std::ios::binary);
+	return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Writing numbers with a DataWriter", "[DataWriter]" ) {
+	GIVEN( "An integer" ) {
+		THEN( "it is written in full" ) {
+			auto value = GENERATE(as<int64_t>{}
+				, 0
+				, 7
+				, -42
+				, 123456789012
+				, std::numeric_limits<int64_t>::max()
+				, std::numeric_limits<int64_t>::min()
+			);
+			CAPTURE( value );
+			CHECK( WriterFormat(value) == StreamFormat(value) );
+			CHECK( WriterFormat(static_cast<int>(value)) == StreamFormat(static_cast<int>(value)) );
+		}
+		THEN( "unsigned values are written in full" ) {
+			CHECK( WriterFormat(std::numeric_limits<uint64_t>::max()) == "18446744073709551615" );
+		}
+	}
+	GIVEN( "A character or a boolean" ) {
+		THEN( "it is written just as a stream would write it" ) {
+			CHECK( WriterFormat('x') == StreamFormat('x') );
+			CHECK( WriterFormat(static_cast<signed char>('y')) == StreamFormat(static_cast<signed char>('y')) );
+			CHECK( WriterFormat(static_cast<unsigned char>('z')) == StreamFormat(static_cast<unsigned char>('z')) );
+			CHECK( WriterFormat('x') == "x" );
+			CHECK( WriterFormat(true) == StreamFormat(true) );
+			CHECK( WriterFormat(false) == StreamFormat(false) );
+		}
+	}
+	GIVEN( "A floating point number" ) {
+		THEN( "it has at most 8 significant digits" ) {
+			auto value = GENERATE(as<double>{}
+				, 0.
+				, -0.
+				, 1.
+				, -3.
+				, .5
+				, 1. / 3.
+				, -2.75
+				, 12345678.
+				, 99999999.
+				, 100000000.
+				, 123456789.
+				, 99999999.5
+				, 1e-7
+				, 6.02214076e23
+				, -1e300
+			);
+			CAPTURE( value );
+			CHECK( WriterFormat(value) == StreamFormat(value) );
+			CHECK( WriterFormat(static_cast<float>(value)) == StreamFormat(static_cast<float>(value)) );
+		}
+	}
+}
+
+SCENARIO( "Writing tokens with a DataWriter", "[DataWriter]" ) {
+	GIVEN( "A line of several tokens" ) {
+		DataWriter writer("");
+		writer.Write("ship", "Bulk Freighter", 3, 1.5);
+		writer.BeginChild();
+		{
+			writer.Write("say", "\"hi\"");
+		}
+		writer.EndChild();
+		THEN( "they are quoted and indented as needed" ) {
+			CHECK( writer.GetString() == "ship \"Bulk Freighter\" 3 1.5\n\tsay `\"hi\"`\n" );
+		}
+	}
+}
+
+SCENARIO( "Saving a file with a DataWriter", "[DataWriter]" ) {
+	GIVEN( "A path to write to" ) {
+		const std::string path = "test_datawriter.txt";
+		const std::string temp = path + "~";
+		std::remove(path.c_str());
+		std::remove(temp.c_str());
+		
+		// Write enough lines that some of them are flushed before the end.
+		std::string expected;
+		{
+			DataWriter writer(path);
+			for(int i = 0; i < 10000; ++i)
+			{
+				writer.Write("line", i, "of some data");
+				expected += "line " + std::to_string(i) + " \"of some data\"\n";
+			}
+			THEN( "the data is written to a temporary file until the writer is destroyed" ) {
+				CHECK( FileExists(temp) );
+				CHECK_FALSE( FileExists(path) );
+			}
+		}
+		THEN( "the file is moved into place once the writer is destroyed" ) {
+			CHECK( FileExists(path) );
+			CHECK_FALSE( FileExists(temp) );
+			CHECK( ReadFile(path) == expected );
+		}
+		std::remove(path.c_str());
+		std::remove(temp.c_str());
+	}
+}
+// #endregion unit tests
+
+
+
+} // test namespace
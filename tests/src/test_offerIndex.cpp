@@ -0,0 +1,102 @@
+/* test_offerIndex.cpp
+Copyright (c) 2021 by Michael Zahniser
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../source/OfferIndex.h"
+
+// Include the classes needed to define missions and the player's conditions.
+#include "../../source/ConditionsStore.h"
+#include "../../source/DataFile.h"
+#include "../../source/DataNode.h"
+#include "../../source/Random.h"
+
+// ... and any system includes needed for the test file.
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace { // test namespace
+
+// #region mock data
+// Define missions from the given text.
+void Load(Set<Mission> &missions, const std::string &text)
+{
+	std::stringstream in;
+	in.str(text);
+	const auto file = DataFile{in};
+	for(const DataNode &node : file)
+		missions.Get(node.Token(1))->Load(node);
+}
+
+bool Contains(const std::vector<const Mission *> &offers, const Mission *mission)
+{
+	return std::find(offers.begin(), offers.end(), mission) != offers.end();
+}
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Finding which missions might be offered", "[OfferIndex]" ) {
+	Set<Mission> missions;
+	Load(missions,
+		"mission \"Rare\"\n"
+		"\tboarding\n"
+		"\tto offer\n"
+		"\t\trandom < 10\n"
+		"mission \"Known\"\n"
+		"\tboarding\n"
+		"\tto offer\n"
+		"\t\thas \"known\"\n");
+	const Mission *rare = missions.Find("Rare");
+	const Mission *known = missions.Find("Known");
+	REQUIRE( rare );
+	REQUIRE( known );
+	OfferIndex index(missions);
+	
+	GIVEN( "A mission that is offered at random" ) {
+		ConditionsStore conditions;
+		THEN( "it is always a candidate, so that Mission::CanOffer() rolls for it just once" ) {
+			for(int i = 0; i < 100; ++i)
+			{
+				Random::Seed(i);
+				CHECK( Contains(index.Missions(Mission::BOARDING, conditions), rare) );
+				// No random numbers were used to find the candidates.
+				uint32_t next = Random::Int();
+				Random::Seed(i);
+				CHECK( Random::Int() == next );
+			}
+		}
+	}
+	GIVEN( "A mission whose offer test does not depend on random numbers" ) {
+		ConditionsStore conditions;
+		THEN( "it is only a candidate if its offer test passes" ) {
+			CHECK_FALSE( Contains(index.Missions(Mission::BOARDING, conditions), known) );
+			conditions["known"] = 1;
+			CHECK( Contains(index.Missions(Mission::BOARDING, conditions), known) );
+			conditions["known"] = 0;
+			CHECK_FALSE( Contains(index.Missions(Mission::BOARDING, conditions), known) );
+		}
+		THEN( "it is only offered on the ships it is meant for" ) {
+			conditions["known"] = 1;
+			CHECK_FALSE( Contains(index.Missions(Mission::ASSISTING, conditions), known) );
+		}
+	}
+}
+// #endregion unit tests
+
+
+
+} // test namespace